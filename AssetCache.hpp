@@ -0,0 +1,147 @@
+#ifndef ASSET_CACHE_HPP
+#define ASSET_CACHE_HPP
+
+#include "all_headers.hpp"
+
+// Format of every decoded clip, which is also the mixer's output format
+constexpr int kAudioFrequency = 48000;
+constexpr int kAudioChannels = 2;
+
+struct SoundClip {
+    std::vector<Sint16> samples;  // Interleaved 16-bit, kAudioChannels per frame
+    size_t frames() const { return samples.size() / kAudioChannels; }
+};
+
+// Decoded sounds keyed by file name. Each WAV is loaded and converted to the mixer format
+// once; later requests for the same name share the result. get() decodes on first use,
+// prefetch() starts decoding ahead of time on the loader pool (or at once without one), so
+// a sound prefetched when its layout is loaded plays without touching the disk. Files that
+// fail to load are remembered too and not retried.
+//
+// Clips live as long as the cache, so raw pointers handed out by get() stay valid. All
+// methods may be called from any thread.
+class AssetCache {
+public:
+    explicit AssetCache(ThreadPool* loader = nullptr) : loader(loader) {}
+
+    // Prefetches still decoding on the pool must not outlive the cache
+    ~AssetCache() {
+        for (auto& entry : clips) {
+            entry.second.wait();
+        }
+    }
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // Clip for the file, or nullptr if it cannot be loaded. Decodes on the calling thread if
+    // nobody has asked for the file yet, and waits if a prefetch is still decoding it.
+    const SoundClip* get(const std::string& fileName) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto found = clips.find(fileName);
+        if (found != clips.end()) {
+            std::shared_future<ClipPtr> clip = found->second;
+            if (clip.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++stalls;
+            }
+            // Wait outside the lock so other files can be requested meanwhile
+            lock.unlock();
+            return clip.get().get();
+        }
+
+        std::promise<ClipPtr> decoded;
+        clips.emplace(fileName, decoded.get_future().share());
+        ++stalls;
+        lock.unlock();
+        ClipPtr clip = decode(fileName);
+        decoded.set_value(clip);
+        return clip.get();
+    }
+
+    // Start loading the file if it is not cached or loading already
+    void prefetch(const std::string& fileName) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (clips.count(fileName)) {
+            return;
+        }
+        if (loader) {
+            clips.emplace(fileName, loader->submit([this, fileName] { return decode(fileName); }).share());
+        } else {
+            std::promise<ClipPtr> decoded;
+            decoded.set_value(decode(fileName));
+            clips.emplace(fileName, decoded.get_future().share());
+        }
+    }
+
+    // True once the file has been decoded (or has failed to load)
+    bool isReady(const std::string& fileName) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = clips.find(fileName);
+        return found != clips.end() && found->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return clips.size();
+    }
+
+    // Files decoded so far, and get() calls that had to decode or wait for a decode
+    uint64_t getDecodes() const { return decodes.load(); }
+    uint64_t getStalls() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stalls;
+    }
+
+    // Load a WAV file and convert it to the mixer format; nullptr on failure
+    static std::unique_ptr<SoundClip> decodeWav(const std::string& fileName) {
+        SDL_AudioSpec wavSpec{};
+        Uint8* wavData = nullptr;
+        Uint32 wavSize = 0;
+        if (SDL_LoadWAV(fileName.c_str(), &wavSpec, &wavData, &wavSize) == nullptr) {
+            std::cerr << "Failed to load WAV file " << fileName << ": " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+
+        SDL_AudioCVT cvt;
+        if (SDL_BuildAudioCVT(&cvt, wavSpec.format, wavSpec.channels, wavSpec.freq, AUDIO_S16SYS, kAudioChannels, kAudioFrequency) < 0) {
+            std::cerr << "Cannot convert " << fileName << " to the mixer format: " << SDL_GetError() << std::endl;
+            SDL_FreeWAV(wavData);
+            return nullptr;
+        }
+        // SDL_ConvertAudio works in place and needs len * len_mult bytes
+        std::vector<Uint8> buffer(static_cast<size_t>(wavSize) * cvt.len_mult);
+        std::memcpy(buffer.data(), wavData, wavSize);
+        SDL_FreeWAV(wavData);
+        cvt.buf = buffer.data();
+        cvt.len = static_cast<int>(wavSize);
+        size_t bytes = wavSize;
+        if (cvt.needed) {
+            if (SDL_ConvertAudio(&cvt) < 0) {
+                std::cerr << "Failed to convert " << fileName << ": " << SDL_GetError() << std::endl;
+                return nullptr;
+            }
+            bytes = static_cast<size_t>(cvt.len_cvt);
+        }
+
+        auto clip = std::make_unique<SoundClip>();
+        clip->samples.resize(bytes / sizeof(Sint16) / kAudioChannels * kAudioChannels);
+        std::memcpy(clip->samples.data(), buffer.data(), clip->samples.size() * sizeof(Sint16));
+        return clip;
+    }
+
+private:
+    using ClipPtr = std::shared_ptr<const SoundClip>;
+
+    ThreadPool* loader;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_future<ClipPtr>> clips;
+    uint64_t stalls = 0;
+    std::atomic<uint64_t> decodes{0};
+
+    ClipPtr decode(const std::string& fileName) {
+        ++decodes;
+        return ClipPtr(decodeWav(fileName));
+    }
+};
+
+#endif // ASSET_CACHE_HPP
@@ -0,0 +1,81 @@
+#ifndef EVENT_QUEUE_HPP
+#define EVENT_QUEUE_HPP
+
+#include "all_headers.hpp"
+
+// Collects input events between frames and dispatches them to a layout tree once per frame.
+// Consecutive SHOW (hover) events collapse into the latest mouse position, since only where
+// the mouse ended up affects what is shown, so a fast mouse flick costs one tree walk per
+// frame instead of one per motion event. CLICK events are never merged and keep their
+// order relative to each other and to the hover positions around them.
+//
+// Events are held by value in a fixed ring allocated with the queue, so pushing and
+// dispatching never touch the heap. With coalescing, the ring only fills if kCapacity
+// events other than hovers arrive within one frame; further events are then dropped and
+// counted.
+class EventQueue {
+public:
+    static constexpr uint32_t kCapacity = 256;  // Power of two
+
+    void push(const Event& event) {
+        ++received;
+        // Events already being dispatched are not merged into
+        if (event.type == EventType::SHOW && tail != sealed && back().type == EventType::SHOW) {
+            back().x = event.x;
+            back().y = event.y;
+            return;
+        }
+        if (tail - head == kCapacity) {
+            ++dropped;
+            return;
+        }
+        ring[tail & (kCapacity - 1)] = event;
+        ++tail;
+    }
+
+    // Queue the layout event for an SDL mouse event; returns false for any other event
+    bool push(const SDL_Event& event) {
+        if (event.type == SDL_MOUSEMOTION) {
+            push(Event(EventType::SHOW, event.motion.x, event.motion.y));
+            return true;
+        }
+        if (event.type == SDL_MOUSEBUTTONDOWN) {
+            push(Event(EventType::CLICK, event.button.x, event.button.y));
+            return true;
+        }
+        return false;
+    }
+
+    // Send the queued events to root in order and empty the queue
+    void dispatch(Layout& root, SoundPlayer* soundPlayer) {
+        // Seal the batch first, so events queued by handlers wait for the next frame
+        sealed = tail;
+        while (head != sealed) {
+            Event event = ring[head & (kCapacity - 1)];
+            ++head;
+            ++dispatched;
+            root.handleEvent(event, soundPlayer);
+        }
+    }
+
+    bool empty() const { return head == tail; }
+    size_t size() const { return tail - head; }
+
+    // Events pushed, handed to a layout, and dropped on a full ring since construction
+    uint64_t getReceived() const { return received; }
+    uint64_t getDispatched() const { return dispatched; }
+    uint64_t getDropped() const { return dropped; }
+
+private:
+    std::array<Event, kCapacity> ring{};
+    uint32_t head = 0;    // Next event to dispatch; counters wrap, indices are masked
+    uint32_t tail = 0;    // Where the next event goes
+    uint32_t sealed = 0;  // End of the batch being (or last) dispatched
+    uint64_t received = 0;
+    uint64_t dispatched = 0;
+    uint64_t dropped = 0;
+
+    Event& back() { return ring[(tail - 1) & (kCapacity - 1)]; }
+};
+
+#endif // EVENT_QUEUE_HPP
@@ -2,24 +2,31 @@
 #define EVENT_SYSTEM_HPP
 
 #include "all_headers.hpp"
+#include "SoundNames.hpp"
 
 enum class EventType { CLICK, SOUND, SHOW };
 
+// Trivially copyable, so queues can hold events by value in preallocated storage
 struct Event {
     EventType type;
     int x = 0, y = 0;  // Coordinates for CLICK and SHOW events
-    std::string soundFile;  // Filename for SOUND events
+    SoundId sound = SoundId::None;  // Interned file name for SOUND events
+
+    // Empty slot in a preallocated queue
+    Event() = default;
 
     // Constructor for CLICK and SHOW events
     Event(EventType eventType, int xPos = 0, int yPos = 0)
         : type(eventType), x(xPos), y(yPos) {}
 
     // Constructor for SOUND events
-    Event(EventType eventType, const std::string& file)
-        : type(eventType), soundFile(file) {}
+    Event(EventType eventType, SoundId soundId)
+        : type(eventType), sound(soundId) {}
 };
+static_assert(std::is_trivially_copyable<Event>::value, "Event must stay trivially copyable");
 
-class ButtonElement : public Element {
+// Plain button data, kept by ElementStore without an Element vptr (see LineData)
+struct ButtonData {
     ivec2 position;
     ivec2 size;
     ivec3 color;
@@ -27,10 +34,6 @@ class ButtonElement : public Element {
     bool hoverable;   // Specifies if the button should respond to hover events
     bool clickable;   // Specifies if the button should respond to click events
 
-public:
-    ButtonElement(const ivec2& pos, const ivec2& sz, const ivec3& clr, bool isHoverable = false, bool isClickable = true)
-        : position(pos), size(sz), color(clr), clicked(false), hoverable(isHoverable), clickable(isClickable) {}
-
     // Method to handle CLICK events only if clickable is enabled
     bool handleEvent(const Event& event) {
         if (clickable && event.type == EventType::CLICK && wasClicked(event)) {
@@ -49,19 +52,58 @@ public:
         return (event.type == EventType::CLICK && isInside({event.x, event.y}));
     }
 
-    bool isInside(const ivec2& point) const override {
+    bool isInside(const ivec2& point) const {
         return (point.x >= position.x && point.x <= position.x + size.x &&
                 point.y >= position.y && point.y <= position.y + size.y);
     }
 
-    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override {
+    // Points accepted by isInside, as a rectangle (empty for a negative size)
+    Rect hitArea() const {
+        return Rect(position.x, position.y, position.x + size.x, position.y + size.y);
+    }
+
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const {
         ivec2 topLeft = position + start;
         ivec2 bottomRight = topLeft + size;
         screen.drawSafeBox(topLeft, bottomRight, color);
     }
 
+    Rect bounds(const ivec2& start, const ivec2& end) const {
+        ivec2 topLeft = position + start;
+        ivec2 bottomRight = topLeft + size;
+        return Rect(std::min(topLeft.x, bottomRight.x), std::min(topLeft.y, bottomRight.y),
+                    std::max(topLeft.x, bottomRight.x), std::max(topLeft.y, bottomRight.y));
+    }
+
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const {
+        ivec2 topLeft = position + start;
+        list.addBox(topLeft, topLeft + size, color);
+    }
+
     bool isHoverable() const { return hoverable; }
     bool isClickable() const { return clickable; }
 };
 
+class ButtonElement final : public Element {
+    ButtonData data;
+
+public:
+    ButtonElement(const ivec2& pos, const ivec2& sz, const ivec3& clr, bool isHoverable = false, bool isClickable = true)
+        : data{pos, sz, clr, false, isHoverable, isClickable} {}
+
+    bool handleEvent(const Event& event) { return data.handleEvent(event); }
+    bool handleHover(const Event& event) const { return data.handleHover(event); }
+    bool wasClicked(const Event& event) const { return data.wasClicked(event); }
+    bool isInside(const ivec2& point) const override { return data.isInside(point); }
+    Rect hitArea() const { return data.hitArea(); }
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override { data.draw(screen, start, end); }
+    Rect bounds(const ivec2& start, const ivec2& end) const override { return data.bounds(start, end); }
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const override { data.record(list, start, end); }
+
+    void storeInto(ElementStore& store) const override; // Defined in layout/element_store.cpp
+
+    bool isHoverable() const { return data.isHoverable(); }
+    bool isClickable() const { return data.isClickable(); }
+};
+
 #endif // EVENT_SYSTEM_HPP
@@ -0,0 +1,95 @@
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include "all_headers.hpp"
+#include <chrono>
+
+// Paces a render loop to a target frame rate without a fixed sleep:
+//
+//   while (running) {
+//       SDL_Event event;
+//       while (scheduler.waitEvent(event, layout->hasDirtyRegions())) { ...handle event... }
+//       if (layout->hasDirtyRegions()) {
+//           scheduler.beginRender();
+//           ...render and present...
+//           scheduler.endRender();
+//       }
+//   }
+//
+// Frames start on a fixed grid of intervals, so the time spent rendering comes out of the
+// frame's budget instead of being added to it. waitEvent returns pending input at once and
+// otherwise waits in SDL_WaitEventTimeout, which wakes as soon as input arrives: with
+// something dirty only until the next frame is due, with nothing dirty (no frame to draw) up
+// to idleTimeoutMs, so an idle window costs no renders. Input that arrives after a quiet
+// period is therefore drawn immediately rather than up to two frames later.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(double targetFps = 60.0, int idleTimeoutMs = 100)
+        : frameInterval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps))),
+          idleTimeoutMs(idleTimeoutMs), nextFrame(Clock::now()) {}
+
+    // Next input event, or false when it is time to render (dirty) or the idle timeout passed
+    bool waitEvent(SDL_Event& event, bool dirty) {
+        if (SDL_PollEvent(&event)) {
+            return true;
+        }
+
+        int timeoutMs = idleTimeoutMs;
+        if (dirty) {
+            Clock::duration remaining = nextFrame - Clock::now();
+            if (remaining <= Clock::duration::zero()) {
+                return false;
+            }
+            // Round up so a wait shorter than a millisecond does not spin
+            timeoutMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+        }
+
+        if (SDL_WaitEventTimeout(&event, timeoutMs)) {
+            return true;
+        }
+        if (!dirty) {
+            ++idleWakeups;
+        }
+        return false;
+    }
+
+    // Mark the start of a rendered frame and schedule the next one
+    void beginRender() {
+        renderStart = Clock::now();
+        // Stay on the frame grid while keeping up; after an idle gap or a slow frame, restart
+        // the grid from now instead of rendering a burst of catch-up frames
+        nextFrame += frameInterval;
+        if (nextFrame <= renderStart) {
+            nextFrame = renderStart + frameInterval;
+        }
+    }
+
+    // Mark the end of the frame begun by beginRender and record what it cost
+    void endRender() {
+        double renderMs = std::chrono::duration<double, std::milli>(Clock::now() - renderStart).count();
+        lastRenderMs = renderMs;
+        worstRenderMs = std::max(worstRenderMs, renderMs);
+        totalRenderMs += renderMs;
+        ++framesRendered;
+    }
+
+    double getLastRenderMs() const { return lastRenderMs; }
+    double getWorstRenderMs() const { return worstRenderMs; }
+    double getAverageRenderMs() const { return framesRendered ? totalRenderMs / framesRendered : 0.0; }
+    double getFrameIntervalMs() const { return std::chrono::duration<double, std::milli>(frameInterval).count(); }
+    uint64_t getFramesRendered() const { return framesRendered; }
+    uint64_t getIdleWakeups() const { return idleWakeups; }
+
+private:
+    Clock::duration frameInterval;
+    int idleTimeoutMs;
+    Clock::time_point nextFrame;    // Earliest start of the next rendered frame
+    Clock::time_point renderStart;
+    double lastRenderMs = 0.0, worstRenderMs = 0.0, totalRenderMs = 0.0;
+    uint64_t framesRendered = 0;
+    uint64_t idleWakeups = 0;       // Timeouts with nothing to draw and no input
+};
+
+#endif // FRAME_SCHEDULER_HPP
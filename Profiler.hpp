@@ -0,0 +1,234 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hot-path instrumentation, compiled in only with -DGUI_PROFILE (make PROFILE=1).
+//
+//   PROFILE_SCOPE("Layout::render");   time the enclosing scope
+//   PROFILE_PIXELS(count);             credit pixels written to the open scopes on this thread
+//   PROFILE_FRAME();                   close the current frame
+//   PROFILE_WRITE("trace.json");       print the per-frame report and write a Chrome trace
+//
+// Without GUI_PROFILE the macros expand to nothing. Each scope becomes one trace event with
+// its duration and the pixels written inside it. At every frame boundary the events are
+// folded into per-name statistics: call time, and time and pixels per frame, reported as
+// p50/p99. A recursive call of an already open scope is not timed again, so recursion is
+// counted once. Events are buffered per thread, so scopes may run on ThreadPool workers.
+class Profiler {
+public:
+    struct Event {
+        const char* name;
+        uint64_t startNs, durationNs;
+        uint64_t pixels;
+        uint32_t thread;
+    };
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - instance().epoch).count());
+    }
+
+    // Per-thread state: open scopes and the running pixel count
+    struct ThreadState {
+        static constexpr int kMaxDepth = 64;
+        const char* open[kMaxDepth];
+        int depth = 0;
+        uint64_t pixels = 0;
+        uint32_t id = 0;
+        std::mutex mutex;  // Guards events against collection in endFrame
+        std::vector<Event> events;
+    };
+
+    static ThreadState& threadState() {
+        thread_local ThreadState* state = instance().registerThread();
+        return *state;
+    }
+
+    // Times one scope; inactive if the same name is already open on this thread
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name(name) {
+            ThreadState& state = threadState();
+            for (int i = 0; i < state.depth; ++i) {
+                if (state.open[i] == name) return;
+            }
+            if (state.depth == ThreadState::kMaxDepth) return;
+            state.open[state.depth++] = name;
+            active = true;
+            startPixels = state.pixels;
+            startNs = now();
+        }
+
+        ~Scope() {
+            if (!active) return;
+            uint64_t endNs = now();
+            ThreadState& state = threadState();
+            --state.depth;
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.events.push_back({name, startNs, endNs - startNs, state.pixels - startPixels, state.id});
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        bool active = false;
+        uint64_t startNs = 0, startPixels = 0;
+    };
+
+    static void addPixels(uint64_t count) { threadState().pixels += count; }
+
+    // Collect every thread's events for the frame that just ended
+    void endFrame() {
+        uint64_t frameEnd = now();
+        std::map<std::string, Totals> frameTotals;
+
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        for (auto& state : threads) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            for (const Event& event : state->events) {
+                Stats& stats = statsByName[event.name];
+                stats.callNs.push_back(event.durationNs);
+                Totals& totals = frameTotals[event.name];
+                totals.ns += event.durationNs;
+                totals.pixels += event.pixels;
+                if (trace.size() < kMaxTraceEvents) {
+                    trace.push_back(event);
+                } else {
+                    ++droppedEvents;
+                }
+            }
+            state->events.clear();
+        }
+
+        for (auto& entry : statsByName) {
+            const Totals& totals = frameTotals[entry.first];
+            entry.second.frameNs.push_back(totals.ns);
+            entry.second.framePixels.push_back(totals.pixels);
+        }
+        frames.push_back({frameStart, frameEnd - frameStart});
+        frameStart = frameEnd;
+    }
+
+    // Per-name table: calls per frame, then p50/p99 of call time, frame time and frame pixels
+    void writeReport(std::ostream& out) {
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        out << "Profile over " << frames.size() << " frames (times in us, p50 / p99):\n";
+        out << std::left << std::setw(28) << "  scope" << std::right << std::setw(12) << "calls/frame"
+            << std::setw(22) << "per call" << std::setw(22) << "per frame" << std::setw(24) << "pixels/frame" << "\n";
+        for (auto& entry : statsByName) {
+            Stats& stats = entry.second;
+            double callsPerFrame = frames.empty() ? 0.0 : static_cast<double>(stats.callNs.size()) / frames.size();
+            out << "  " << std::left << std::setw(26) << entry.first << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << callsPerFrame << std::setprecision(2)
+                << std::setw(11) << percentile(stats.callNs, 50) / 1000.0 << std::setw(11) << percentile(stats.callNs, 99) / 1000.0
+                << std::setw(11) << percentile(stats.frameNs, 50) / 1000.0 << std::setw(11) << percentile(stats.frameNs, 99) / 1000.0
+                << std::setw(12) << percentile(stats.framePixels, 50) << std::setw(12) << percentile(stats.framePixels, 99) << "\n";
+            out.unsetf(std::ios::fixed);
+        }
+        if (droppedEvents) {
+            out << "  (" << droppedEvents << " events beyond the trace limit were left out of the trace)\n";
+        }
+    }
+
+    // Chrome trace format ("X" complete events, microsecond timestamps); one event per scope
+    // call and one per frame, loadable in chrome://tracing or Perfetto
+    bool writeChromeTrace(const std::string& fileName) {
+        std::ofstream file(fileName);
+        if (!file) {
+            std::cerr << "Error: Could not write trace " << fileName << "\n";
+            return false;
+        }
+
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        file << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            file << (first ? "" : ",\n") << "{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":"
+                 << frames[i].startNs / 1000.0 << ",\"dur\":" << frames[i].durationNs / 1000.0 << ",\"args\":{\"frame\":" << i << "}}";
+            first = false;
+        }
+        for (const Event& event : trace) {
+            file << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                 << ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0
+                 << ",\"args\":{\"pixels\":" << event.pixels << "}}";
+            first = false;
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+private:
+    static constexpr size_t kMaxTraceEvents = 2000000;
+
+    struct Totals {
+        uint64_t ns = 0, pixels = 0;
+    };
+    struct Stats {
+        std::vector<uint64_t> callNs, frameNs, framePixels;
+    };
+    struct Frame {
+        uint64_t startNs, durationNs;
+    };
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadState>> threads;  // Never freed: threads keep a pointer to theirs
+    std::map<std::string, Stats> statsByName;
+    std::vector<Event> trace;
+    std::vector<Frame> frames;
+    uint64_t frameStart = 0;
+    size_t droppedEvents = 0;
+
+    ThreadState* registerThread() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threads.push_back(std::make_unique<ThreadState>());
+        threads.back()->id = static_cast<uint32_t>(threads.size());
+        return threads.back().get();
+    }
+
+    static uint64_t percentile(std::vector<uint64_t>& values, int percent) {
+        if (values.empty()) return 0;
+        size_t rank = (values.size() - 1) * percent / 100;
+        std::nth_element(values.begin(), values.begin() + rank, values.end());
+        return values[rank];
+    }
+};
+
+#ifdef GUI_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_PIXELS(count) Profiler::addPixels(static_cast<uint64_t>(count))
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+#define PROFILE_WRITE(fileName)                               \
+    do {                                                      \
+        Profiler::instance().writeReport(std::cout);          \
+        Profiler::instance().writeChromeTrace(fileName);      \
+    } while (0)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_PIXELS(count) do {} while (0)
+#define PROFILE_FRAME() do {} while (0)
+#define PROFILE_WRITE(fileName) do {} while (0)
+#endif
+
+#endif // PROFILER_HPP
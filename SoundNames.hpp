@@ -0,0 +1,53 @@
+#ifndef SOUND_NAMES_HPP
+#define SOUND_NAMES_HPP
+
+#include "all_headers.hpp"
+#include <deque>
+#include <mutex>
+
+// Interned sound file name. Layouts and events carry this 32-bit id instead of a string, so
+// an event stays trivially copyable and playing a layout's sound copies no name.
+enum class SoundId : uint32_t { None = 0 };  // None: no sound named, the default clip plays
+
+// Process-wide table of interned sound file names. Ids are handed out in first-seen order and
+// never reused; names live as long as the program, so references from name() stay valid.
+// Layouts are built on loader threads too, so both calls take a lock; neither allocates once
+// a name is interned.
+class SoundNames {
+public:
+    // Id of a file name, adding it on first use; the empty name is SoundId::None
+    static SoundId intern(std::string_view fileName) {
+        if (fileName.empty()) {
+            return SoundId::None;
+        }
+        SoundNames& table = instance();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto found = table.ids.find(fileName);
+        if (found != table.ids.end()) {
+            return found->second;
+        }
+        table.names.emplace_back(fileName);
+        SoundId id = static_cast<SoundId>(table.names.size() - 1);
+        table.ids.emplace(table.names.back(), id);
+        return id;
+    }
+
+    // File name of an id; empty for SoundId::None
+    static const std::string& name(SoundId id) {
+        SoundNames& table = instance();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        return table.names[static_cast<size_t>(id)];
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<std::string> names{std::string()};  // Indexed by id; deque keeps references stable
+    std::unordered_map<std::string_view, SoundId> ids;  // Views into names
+
+    static SoundNames& instance() {
+        static SoundNames table;
+        return table;
+    }
+};
+
+#endif // SOUND_NAMES_HPP
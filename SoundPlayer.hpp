@@ -2,51 +2,230 @@
 #define SOUND_PLAYER_HPP
 
 #include "all_headers.hpp"
+#include "AssetCache.hpp"
+#include "SoundNames.hpp"
+#include <atomic>
 
+// Callback-driven sound mixer. Clips are decoded once, through an AssetCache keyed by file
+// name, into the device format (interleaved 16-bit stereo at kFrequency) and kept in memory;
+// prefetch() decodes ahead of the first play on the loader pool. playSound/play only
+// push a command onto a lock-free single-producer/single-consumer ring; the audio callback
+// takes the commands at the start of each buffer and mixes every playing voice into it.
+// Voices overlap instead of cutting each other off, and a sound starts within one buffer of
+// kBufferFrames frames (about 5 ms) of the call.
+//
+// Threading: load*, play* and the destructor belong to one (UI) thread; mix runs on SDL's
+// audio thread. Clips are never modified or freed while the device is open.
 class SoundPlayer {
 public:
-    SoundPlayer() {
+    static constexpr int kFrequency = kAudioFrequency;
+    static constexpr int kChannels = kAudioChannels;
+    static constexpr int kBufferFrames = 256;
+    static constexpr int kMaxVoices = 16;           // Further sounds replace the longest-playing voice
+    static constexpr uint32_t kCommandCapacity = 64; // Power of two
+
+    using Clip = SoundClip;
+
+    // With openDevice false no audio device is opened and nothing plays by itself; the
+    // caller pulls output with mix() instead (tests, offline rendering). Prefetched sounds
+    // are decoded on loader, or right away without one.
+    explicit SoundPlayer(bool openDevice = true, ThreadPool* loader = nullptr) : assets(loader) {
         if (SDL_Init(SDL_INIT_AUDIO) < 0) {
             std::cerr << "Error initializing SDL audio: " << SDL_GetError() << std::endl;
             std::quick_exit(1);
         }
+        if (openDevice) {
+            SDL_AudioSpec desired{};
+            desired.freq = kFrequency;
+            desired.format = AUDIO_S16SYS;
+            desired.channels = kChannels;
+            desired.samples = kBufferFrames;
+            desired.callback = audioCallback;
+            desired.userdata = this;
+            // No allowed changes: SDL converts to the hardware format if it differs
+            audioDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, nullptr, 0);
+            if (audioDevice == 0) {
+                std::cerr << "Failed to open audio device: " << SDL_GetError() << std::endl;
+            } else {
+                SDL_PauseAudioDevice(audioDevice, 0);  // Mixes silence until something plays
+            }
+        }
     }
 
     ~SoundPlayer() {
         if (audioDevice != 0) {
-            SDL_CloseAudioDevice(audioDevice);
-            SDL_FreeWAV(audioData);
+            SDL_CloseAudioDevice(audioDevice);  // Stops the callback before the clips go away
         }
         SDL_QuitSubSystem(SDL_INIT_AUDIO);  // Quit only audio subsystem
     }
 
+    SoundPlayer(const SoundPlayer&) = delete;
+    SoundPlayer& operator=(const SoundPlayer&) = delete;
+
+    // Decode a WAV file (once, through the asset cache) and give it a clip id; -1 on failure
+    int loadClip(const std::string& soundFile) {
+        const Clip* clip = assets.get(soundFile);
+        if (!clip) {
+            return -1;
+        }
+        clips.push_back(clip);
+        return static_cast<int>(clips.size()) - 1;
+    }
+
+    // Add a clip already in the device format; returns its id
+    int addClip(std::vector<Sint16> samples) {
+        samples.resize(samples.size() / kChannels * kChannels);
+        ownedClips.push_back(std::make_unique<Clip>(Clip{std::move(samples)}));
+        clips.push_back(ownedClips.back().get());
+        return static_cast<int>(clips.size()) - 1;
+    }
+
+    // Start decoding a sound that may be played soon, e.g. one named by a layout just parsed
+    void prefetch(const std::string& soundFile) {
+        assets.prefetch(soundFile);
+    }
+
+    // Load the clip played by playSound() (the first one loaded)
     bool loadSound(const std::string& soundFile) {
-        if (SDL_LoadWAV(soundFile.c_str(), &audioSpec, &audioData, &audioSize) == nullptr) {
-            std::cerr << "Failed to load WAV file: " << SDL_GetError() << std::endl;
+        return loadClip(soundFile) >= 0;
+    }
+
+    // Start a voice playing the clip; returns false for an unknown clip or a full command ring
+    bool play(int clip, int volume = SDL_MIX_MAXVOLUME) {
+        if (clip < 0 || clip >= static_cast<int>(clips.size())) {
             return false;
         }
-        audioDevice = SDL_OpenAudioDevice(nullptr, 0, &audioSpec, nullptr, 0);
-        if (audioDevice == 0) {
-            std::cerr << "Failed to open audio device: " << SDL_GetError() << std::endl;
-            SDL_FreeWAV(audioData);
+        return play(clips[clip], volume);
+    }
+
+    // Play a sound by file name; an empty name plays the first loaded clip
+    void playSound(const std::string& soundFile = std::string()) {
+        if (soundFile.empty()) {
+            play(0);
+        } else if (const Clip* clip = assets.get(soundFile)) {
+            play(clip, SDL_MIX_MAXVOLUME);
+        }
+    }
+
+    // Play an interned sound (a layout's); SoundId::None plays the first loaded clip. Once the
+    // file is decoded this does not allocate.
+    void playSound(SoundId sound) {
+        playSound(SoundNames::name(sound));
+    }
+
+    // Mix the next frames of output (kChannels interleaved samples each) into out. Called by
+    // the audio callback; call it directly only for a player made without a device.
+    void mix(Sint16* out, int frames) {
+        startQueuedVoices();
+
+        Sint32 accumulator[kBufferFrames * kChannels];
+        int playing = 0;
+        for (int done = 0; done < frames; done += kBufferFrames) {
+            int chunkFrames = std::min(kBufferFrames, frames - done);
+            int chunkSamples = chunkFrames * kChannels;
+            std::fill(accumulator, accumulator + chunkSamples, 0);
+
+            playing = 0;
+            for (Voice& voice : voices) {
+                if (!voice.clip) continue;
+                size_t count = std::min(static_cast<size_t>(chunkFrames), voice.clip->frames() - voice.position);
+                const Sint16* source = voice.clip->samples.data() + voice.position * kChannels;
+                for (size_t i = 0; i < count * kChannels; ++i) {
+                    accumulator[i] += source[i] * voice.volume;
+                }
+                voice.position += count;
+                if (voice.position == voice.clip->frames()) {
+                    voice.clip = nullptr;
+                } else {
+                    ++playing;
+                }
+            }
+
+            // Volumes are in 1/SDL_MIX_MAXVOLUME steps; clamp the sum instead of wrapping
+            Sint16* target = out + static_cast<size_t>(done) * kChannels;
+            for (int i = 0; i < chunkSamples; ++i) {
+                Sint32 sample = accumulator[i] / SDL_MIX_MAXVOLUME;
+                target[i] = static_cast<Sint16>(std::max(-32768, std::min(32767, sample)));
+            }
+        }
+
+        activeVoices.store(playing, std::memory_order_relaxed);
+        framesMixed.fetch_add(static_cast<uint64_t>(frames), std::memory_order_relaxed);
+    }
+
+    bool hasDevice() const { return audioDevice != 0; }
+    size_t clipCount() const { return clips.size(); }
+    const Clip& getClip(int clip) const { return *clips[clip]; }
+    AssetCache& getAssets() { return assets; }
+
+    // Counters, safe to read from any thread
+    int getActiveVoices() const { return activeVoices.load(std::memory_order_relaxed); }
+    uint64_t getFramesMixed() const { return framesMixed.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCommands() const { return droppedCommands.load(std::memory_order_relaxed); }
+
+private:
+    struct Command {
+        const Clip* clip;
+        int volume;
+    };
+
+    struct Voice {
+        const Clip* clip = nullptr;  // Null when the voice is free
+        size_t position = 0;         // Next frame to mix
+        int volume = 0;
+    };
+
+    bool play(const Clip* clip, int volume) {
+        uint32_t head = commandHead.load(std::memory_order_relaxed);
+        if (head - commandTail.load(std::memory_order_acquire) == kCommandCapacity) {
+            droppedCommands.fetch_add(1, std::memory_order_relaxed);
             return false;
         }
+        commands[head & (kCommandCapacity - 1)] = {clip, std::max(0, std::min(volume, SDL_MIX_MAXVOLUME))};
+        commandHead.store(head + 1, std::memory_order_release);
         return true;
     }
 
-    void playSound() const {
-        if (audioDevice != 0) {
-            SDL_ClearQueuedAudio(audioDevice);
-            SDL_QueueAudio(audioDevice, audioData, audioSize);
-            SDL_PauseAudioDevice(audioDevice, 0);  // Start playback
+    static void SDLCALL audioCallback(void* userdata, Uint8* stream, int length) {
+        static_cast<SoundPlayer*>(userdata)->mix(reinterpret_cast<Sint16*>(stream), length / static_cast<int>(kChannels * sizeof(Sint16)));
+    }
+
+    // Audio thread: turn queued commands into voices
+    void startQueuedVoices() {
+        uint32_t tail = commandTail.load(std::memory_order_relaxed);
+        uint32_t head = commandHead.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const Command& command = commands[tail & (kCommandCapacity - 1)];
+            Voice* target = &voices[0];
+            for (Voice& voice : voices) {
+                if (!voice.clip) {
+                    target = &voice;
+                    break;
+                }
+                if (voice.position > target->position) {
+                    target = &voice;
+                }
+            }
+            *target = {command.clip, 0, command.volume};
         }
+        commandTail.store(tail, std::memory_order_release);
     }
 
-private:
-    SDL_AudioSpec audioSpec{};
-    Uint8* audioData = nullptr;
-    Uint32 audioSize = 0;
     SDL_AudioDeviceID audioDevice = 0;
+    AssetCache assets;                              // Decoded files; voices point into them
+    std::vector<std::unique_ptr<Clip>> ownedClips;  // Clips added from memory
+    std::vector<const Clip*> clips;                 // Clip ids, in the order they were added
+
+    // Command ring: the UI thread writes at commandHead, the audio thread reads at commandTail
+    std::array<Command, kCommandCapacity> commands{};
+    std::atomic<uint32_t> commandHead{0};
+    std::atomic<uint32_t> commandTail{0};
+
+    std::array<Voice, kMaxVoices> voices{};  // Audio thread only
+
+    std::atomic<int> activeVoices{0};
+    std::atomic<uint64_t> framesMixed{0};
+    std::atomic<uint64_t> droppedCommands{0};
 };
 
 #endif // SOUND_PLAYER_HPP
@@ -0,0 +1,143 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads shared by rendering and loading work
+class ThreadPool {
+public:
+    // A pool of threadCount workers; 0 means one per hardware thread
+    explicit ThreadPool(unsigned int threadCount = 0) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Queue a task and return a future for its result
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged] { (*packaged)(); });
+        }
+        wakeup.notify_one();
+        return result;
+    }
+
+    // Run body(i) for every i in [0, count), spread over the workers and the calling thread.
+    // Returns once every index has been processed. The caller only waits for helpers that
+    // actually started: one still queued behind a long task returns at once when it finally
+    // runs, so a busy pool does not stall the caller, and calling this from inside a task
+    // cannot deadlock.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) return;
+
+        // Shared with the helpers, which may outlive this call if they start late
+        struct Work {
+            std::atomic<size_t> next{0};
+            size_t count;
+            const std::function<void(size_t)>* body;
+            std::mutex mutex;
+            std::condition_variable finished;
+            size_t running = 0;   // Helpers inside drain; guarded by mutex
+            bool closed = false;  // Set once the caller stops accepting helpers; guarded by mutex
+            std::exception_ptr error;  // First exception thrown in a helper; guarded by mutex
+        };
+        auto work = std::make_shared<Work>();
+        work->count = count;
+        work->body = &body;
+        auto drain = [](Work& w) {
+            for (size_t i = w.next.fetch_add(1); i < w.count; i = w.next.fetch_add(1)) {
+                (*w.body)(i);
+            }
+        };
+        auto close = [&work] {
+            std::unique_lock<std::mutex> lock(work->mutex);
+            work->closed = true;
+            work->finished.wait(lock, [&work] { return work->running == 0; });
+        };
+
+        size_t helpers = std::min(workers.size(), count - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            submit([work, drain] {
+                {
+                    std::lock_guard<std::mutex> lock(work->mutex);
+                    if (work->closed) return;
+                    ++work->running;
+                }
+                std::exception_ptr error;
+                try {
+                    drain(*work);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(work->mutex);
+                if (error && !work->error) work->error = error;
+                --work->running;
+                work->finished.notify_all();
+            });
+        }
+        try {
+            drain(*work);
+        } catch (...) {
+            close();
+            throw;
+        }
+        close();
+        if (work->error) std::rethrow_exception(work->error);
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
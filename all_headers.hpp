@@ -4,20 +4,40 @@
 #include <SDL2/SDL.h>
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <charconv>
 #include <array>
 #include <memory>
+#include <memory_resource>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
+
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
 
 #include "vecs/Tvec2.hpp"
 #include "vecs/Tvec3.hpp"
 #include "vecs/matrix.hpp"
 
+#include "screen/Rect.hpp"
+#include "screen/SpanFill.hpp"
 #include "screen/Screen.hpp"
+#include "screen/PPM.hpp"
 #include "gui/GUIFile.hpp"
+#include "layout/display_list.hpp"
 #include "layout/layout.hpp"
+#include "layout/tile_renderer.hpp"
+#include "parse/tokenizer.hpp"
+#include "parse/mapped_file.hpp"
+#include "parse/scene.hpp"
 #include "parse/parse.hpp"
+#include "parse/hot_reload.hpp"
+#include "parse/scene_loader.hpp"
 
 #endif // ALL_HEADERS_HPP
\ No newline at end of file
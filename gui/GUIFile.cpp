@@ -1,75 +1,163 @@
 #include "../all_headers.hpp"
 
-// Implementation of LineElement
-LineElement::LineElement(const std::array<float, 2>& start, const std::array<float, 2>& end, const std::array<float, 3>& color)
-    : start(start), end(end), color(color) {}
+// Implementation of LineData (and LineElement's store hook)
 
-void LineElement::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
-    ivec2 startPoint(static_cast<int>(std::round(start[0])) + offset.x, static_cast<int>(std::round(start[1])) + offset.y);
-    ivec2 endPoint(static_cast<int>(std::round(end[0])) + offset.x, static_cast<int>(std::round(end[1])) + offset.y);
+// Screen endpoints of the line; false if both lie outside the layout and nothing is drawn
+bool LineData::place(const ivec2& offset, const ivec2& limit, ivec2& startPoint, ivec2& endPoint) const {
+    startPoint = ivec2(static_cast<int>(std::round(start[0])) + offset.x, static_cast<int>(std::round(start[1])) + offset.y);
+    endPoint = ivec2(static_cast<int>(std::round(end[0])) + offset.x, static_cast<int>(std::round(end[1])) + offset.y);
 
     // Ensure line is within the bounds of offset and limit
-    if ((startPoint.x < offset.x || startPoint.y < offset.y || startPoint.x > limit.x || startPoint.y > limit.y) &&
-        (endPoint.x < offset.x || endPoint.y < offset.y || endPoint.x > limit.x || endPoint.y > limit.y)) {
-        return;
+    return !((startPoint.x < offset.x || startPoint.y < offset.y || startPoint.x > limit.x || startPoint.y > limit.y) &&
+             (endPoint.x < offset.x || endPoint.y < offset.y || endPoint.x > limit.x || endPoint.y > limit.y));
+}
+
+void LineData::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
+    ivec2 startPoint, endPoint;
+    if (place(offset, limit, startPoint, endPoint)) {
+        screen.drawSafeLine(startPoint, endPoint, ivec3(color[0], color[1], color[2]));
+    }
+}
+
+Rect LineData::bounds(const ivec2& offset, const ivec2& limit) const {
+    ivec2 startPoint, endPoint;
+    if (!place(offset, limit, startPoint, endPoint)) {
+        return Rect();
     }
+    return Rect(std::min(startPoint.x, endPoint.x), std::min(startPoint.y, endPoint.y),
+                std::max(startPoint.x, endPoint.x), std::max(startPoint.y, endPoint.y));
+}
+
+void LineData::record(DisplayList& list, const ivec2& offset, const ivec2& limit) const {
+    ivec2 startPoint, endPoint;
+    if (place(offset, limit, startPoint, endPoint)) {
+        list.addLine(startPoint, endPoint, ivec3(color[0], color[1], color[2]));
+    }
+}
 
-    screen.drawSafeLine(startPoint, endPoint, ivec3(color[0], color[1], color[2]));
+void LineElement::storeInto(ElementStore& store) const {
+    store.add(data);
 }
 
-// Implementation of BoxElement
-BoxElement::BoxElement(const std::array<float, 2>& min, const std::array<float, 2>& max, const std::array<float, 3>& color)
-    : min(min), max(max), color(color) {}
+// Implementation of BoxData (and BoxElement's store hook)
 
-void BoxElement::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
-    ivec2 minPoint(static_cast<int>(std::round(min[0])) + offset.x, static_cast<int>(std::round(min[1])) + offset.y);
-    ivec2 maxPoint(static_cast<int>(std::round(max[0])) + offset.x, static_cast<int>(std::round(max[1])) + offset.y);
+// Screen corners of the box, clamped to the layout; drawing fills between them in either order
+void BoxData::place(const ivec2& offset, const ivec2& limit, ivec2& minPoint, ivec2& maxPoint) const {
+    minPoint = ivec2(static_cast<int>(std::round(min[0])) + offset.x, static_cast<int>(std::round(min[1])) + offset.y);
+    maxPoint = ivec2(static_cast<int>(std::round(max[0])) + offset.x, static_cast<int>(std::round(max[1])) + offset.y);
 
     minPoint.x = std::max(minPoint.x, offset.x);
     minPoint.y = std::max(minPoint.y, offset.y);
     maxPoint.x = std::min(maxPoint.x, limit.x);
     maxPoint.y = std::min(maxPoint.y, limit.y);
+}
 
+void BoxData::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
+    ivec2 minPoint, maxPoint;
+    place(offset, limit, minPoint, maxPoint);
     screen.drawSafeBox(minPoint, maxPoint, ivec3(color[0], color[1], color[2]));
 }
 
-bool BoxElement::isInside(const ivec2& point) const {
+Rect BoxData::bounds(const ivec2& offset, const ivec2& limit) const {
+    ivec2 minPoint, maxPoint;
+    place(offset, limit, minPoint, maxPoint);
+    return Rect(std::min(minPoint.x, maxPoint.x), std::min(minPoint.y, maxPoint.y),
+                std::max(minPoint.x, maxPoint.x), std::max(minPoint.y, maxPoint.y));
+}
+
+void BoxData::record(DisplayList& list, const ivec2& offset, const ivec2& limit) const {
+    ivec2 minPoint, maxPoint;
+    place(offset, limit, minPoint, maxPoint);
+    list.addBox(minPoint, maxPoint, ivec3(color[0], color[1], color[2]));
+}
+
+void BoxElement::storeInto(ElementStore& store) const {
+    store.add(data);
+}
+
+bool BoxData::isInside(const ivec2& point) const {
     return (point.x >= min[0] && point.x <= max[0] && point.y >= min[1] && point.y <= max[1]);
 }
 
-// Implementation of PointElement
-PointElement::PointElement(const std::array<float, 2>& position, const std::array<float, 3>& color)
-    : position(position), color(color) {}
+// Implementation of PointData (and PointElement's store hook)
 
-void PointElement::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
-    ivec2 point(static_cast<int>(std::round(position[0])) + offset.x, static_cast<int>(std::round(position[1])) + offset.y);
+// Screen position of the point; false if it lies outside the layout
+bool PointData::place(const ivec2& offset, const ivec2& limit, ivec2& point) const {
+    point = ivec2(static_cast<int>(std::round(position[0])) + offset.x, static_cast<int>(std::round(position[1])) + offset.y);
+    return point.x >= offset.x && point.y >= offset.y && point.x <= limit.x && point.y <= limit.y;
+}
 
-    if (point.x >= offset.x && point.y >= offset.y && point.x <= limit.x && point.y <= limit.y) {
+void PointData::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
+    ivec2 point;
+    if (place(offset, limit, point)) {
         screen.setSafePixel(point, ivec3(color[0], color[1], color[2]));
     }
 }
 
-bool PointElement::isInside(const ivec2& point) const {
+Rect PointData::bounds(const ivec2& offset, const ivec2& limit) const {
+    ivec2 point;
+    if (place(offset, limit, point)) {
+        return Rect(point.x, point.y, point.x, point.y);
+    }
+    return Rect();
+}
+
+void PointData::record(DisplayList& list, const ivec2& offset, const ivec2& limit) const {
+    ivec2 point;
+    if (place(offset, limit, point)) {
+        list.addPoint(point, ivec3(color[0], color[1], color[2]));
+    }
+}
+
+void PointElement::storeInto(ElementStore& store) const {
+    store.add(data);
+}
+
+bool PointData::isInside(const ivec2& point) const {
     return (point.x == position[0] && point.y == position[1]);
 }
 
-// Implementation of TriangleElement
-TriangleElement::TriangleElement(const std::array<float, 2>& v0, const std::array<float, 2>& v1, const std::array<float, 2>& v2, const std::array<float, 3>& color)
-    : v0(v0), v1(v1), v2(v2), color(color) {}
+// Implementation of TriangleData (and TriangleElement's store hook)
 
-void TriangleElement::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
-    ivec2 v0Point(static_cast<int>(std::round(v0[0])) + offset.x, static_cast<int>(std::round(v0[1])) + offset.y);
-    ivec2 v1Point(static_cast<int>(std::round(v1[0])) + offset.x, static_cast<int>(std::round(v1[1])) + offset.y);
-    ivec2 v2Point(static_cast<int>(std::round(v2[0])) + offset.x, static_cast<int>(std::round(v2[1])) + offset.y);
+// Screen vertices of the triangle; drawn only if at least one vertex lies in the layout
+bool TriangleData::place(const ivec2& offset, const ivec2& limit, ivec2& v0Point, ivec2& v1Point, ivec2& v2Point) const {
+    v0Point = ivec2(static_cast<int>(std::round(v0[0])) + offset.x, static_cast<int>(std::round(v0[1])) + offset.y);
+    v1Point = ivec2(static_cast<int>(std::round(v1[0])) + offset.x, static_cast<int>(std::round(v1[1])) + offset.y);
+    v2Point = ivec2(static_cast<int>(std::round(v2[0])) + offset.x, static_cast<int>(std::round(v2[1])) + offset.y);
+
+    return (v0Point.x >= offset.x && v0Point.y >= offset.y && v0Point.x <= limit.x && v0Point.y <= limit.y) ||
+           (v1Point.x >= offset.x && v1Point.y >= offset.y && v1Point.x <= limit.x && v1Point.y <= limit.y) ||
+           (v2Point.x >= offset.x && v2Point.y >= offset.y && v2Point.x <= limit.x && v2Point.y <= limit.y);
+}
 
-    if ((v0Point.x >= offset.x && v0Point.y >= offset.y && v0Point.x <= limit.x && v0Point.y <= limit.y) ||
-        (v1Point.x >= offset.x && v1Point.y >= offset.y && v1Point.x <= limit.x && v1Point.y <= limit.y) ||
-        (v2Point.x >= offset.x && v2Point.y >= offset.y && v2Point.x <= limit.x && v2Point.y <= limit.y)) {
+void TriangleData::draw(Screen& screen, const ivec2& offset, const ivec2& limit) const {
+    ivec2 v0Point, v1Point, v2Point;
+    if (place(offset, limit, v0Point, v1Point, v2Point)) {
         screen.drawSafeTriangle(v0Point, v1Point, v2Point, ivec3(color[0], color[1], color[2]));
     }
 }
 
-bool TriangleElement::isInside(const ivec2& point) const {
+Rect TriangleData::bounds(const ivec2& offset, const ivec2& limit) const {
+    ivec2 v0Point, v1Point, v2Point;
+    if (!place(offset, limit, v0Point, v1Point, v2Point)) {
+        return Rect();
+    }
+    return Rect(std::min({v0Point.x, v1Point.x, v2Point.x}), std::min({v0Point.y, v1Point.y, v2Point.y}),
+                std::max({v0Point.x, v1Point.x, v2Point.x}), std::max({v0Point.y, v1Point.y, v2Point.y}));
+}
+
+void TriangleData::record(DisplayList& list, const ivec2& offset, const ivec2& limit) const {
+    ivec2 v0Point, v1Point, v2Point;
+    if (place(offset, limit, v0Point, v1Point, v2Point)) {
+        list.addTriangle(v0Point, v1Point, v2Point, ivec3(color[0], color[1], color[2]));
+    }
+}
+
+void TriangleElement::storeInto(ElementStore& store) const {
+    store.add(data);
+}
+
+bool TriangleData::isInside(const ivec2& point) const {
     auto sign = [](const ivec2& p1, const ivec2& p2, const ivec2& p3) {
         return (p1.x - p3.x) * (p2.y - p3.y) - (p2.x - p3.x) * (p1.y - p3.y);
     };
@@ -3,49 +3,108 @@
 
 #include "../all_headers.hpp"
 
+class DisplayList;
+class ElementStore;
+
 // Abstract Base Class for all GUI Elements
 class Element {
 public:
     virtual ~Element() = default;
     virtual void draw(Screen& screen, const ivec2& start, const ivec2& end) const = 0;
     virtual bool isInside(const ivec2& point) const = 0; // Check if a point is inside the element
+    virtual Rect bounds(const ivec2& start, const ivec2& end) const = 0; // Screen area draw() may touch (empty if it draws nothing)
+    virtual void record(DisplayList& list, const ivec2& start, const ivec2& end) const = 0; // Append what draw() would draw as commands
+    virtual void storeInto(ElementStore& store) const = 0; // Copy this element into the store's array for its type
 };
 
-// Concrete Element classes
-class LineElement : public Element {
+// Plain element data: the fields of each element type and the code that places, bounds and
+// records them, with no Element base and so no vptr. ElementStore keeps arrays of these;
+// the Element classes below wrap one for code that handles elements one by one.
+struct LineData {
     std::array<float, 2> start, end;
     std::array<float, 3> color;
-public:
-    LineElement(const std::array<float, 2>& start, const std::array<float, 2>& end, const std::array<float, 3>& color);
-    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override;
-    bool isInside(const ivec2& point) const override { return false; } // Lines are not considered "inside"
+    bool place(const ivec2& offset, const ivec2& limit, ivec2& startPoint, ivec2& endPoint) const;
+    void draw(Screen& screen, const ivec2& offset, const ivec2& limit) const;
+    Rect bounds(const ivec2& offset, const ivec2& limit) const;
+    void record(DisplayList& list, const ivec2& offset, const ivec2& limit) const;
 };
 
-class BoxElement : public Element {
+struct BoxData {
     std::array<float, 2> min, max;
     std::array<float, 3> color;
-public:
-    BoxElement(const std::array<float, 2>& min, const std::array<float, 2>& max, const std::array<float, 3>& color);
-    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override;
-    bool isInside(const ivec2& point) const override;
+    void place(const ivec2& offset, const ivec2& limit, ivec2& minPoint, ivec2& maxPoint) const;
+    void draw(Screen& screen, const ivec2& offset, const ivec2& limit) const;
+    Rect bounds(const ivec2& offset, const ivec2& limit) const;
+    void record(DisplayList& list, const ivec2& offset, const ivec2& limit) const;
+    bool isInside(const ivec2& point) const;
 };
 
-class PointElement : public Element {
+struct PointData {
     std::array<float, 2> position;
     std::array<float, 3> color;
-public:
-    PointElement(const std::array<float, 2>& position, const std::array<float, 3>& color);
-    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override;
-    bool isInside(const ivec2& point) const override;
+    bool place(const ivec2& offset, const ivec2& limit, ivec2& point) const;
+    void draw(Screen& screen, const ivec2& offset, const ivec2& limit) const;
+    Rect bounds(const ivec2& offset, const ivec2& limit) const;
+    void record(DisplayList& list, const ivec2& offset, const ivec2& limit) const;
+    bool isInside(const ivec2& point) const;
 };
 
-class TriangleElement : public Element {
+struct TriangleData {
     std::array<float, 2> v0, v1, v2;
     std::array<float, 3> color;
+    bool place(const ivec2& offset, const ivec2& limit, ivec2& v0Point, ivec2& v1Point, ivec2& v2Point) const;
+    void draw(Screen& screen, const ivec2& offset, const ivec2& limit) const;
+    Rect bounds(const ivec2& offset, const ivec2& limit) const;
+    void record(DisplayList& list, const ivec2& offset, const ivec2& limit) const;
+    bool isInside(const ivec2& point) const;
+};
+
+// Concrete Element classes
+class LineElement final : public Element {
+    LineData data;
+public:
+    LineElement(const std::array<float, 2>& start, const std::array<float, 2>& end, const std::array<float, 3>& color)
+        : data{start, end, color} {}
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override { data.draw(screen, start, end); }
+    Rect bounds(const ivec2& start, const ivec2& end) const override { return data.bounds(start, end); }
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const override { data.record(list, start, end); }
+    void storeInto(ElementStore& store) const override;
+    bool isInside(const ivec2& point) const override { return false; } // Lines are not considered "inside"
+};
+
+class BoxElement final : public Element {
+    BoxData data;
+public:
+    BoxElement(const std::array<float, 2>& min, const std::array<float, 2>& max, const std::array<float, 3>& color)
+        : data{min, max, color} {}
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override { data.draw(screen, start, end); }
+    Rect bounds(const ivec2& start, const ivec2& end) const override { return data.bounds(start, end); }
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const override { data.record(list, start, end); }
+    void storeInto(ElementStore& store) const override;
+    bool isInside(const ivec2& point) const override { return data.isInside(point); }
+};
+
+class PointElement final : public Element {
+    PointData data;
+public:
+    PointElement(const std::array<float, 2>& position, const std::array<float, 3>& color) : data{position, color} {}
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override { data.draw(screen, start, end); }
+    Rect bounds(const ivec2& start, const ivec2& end) const override { return data.bounds(start, end); }
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const override { data.record(list, start, end); }
+    void storeInto(ElementStore& store) const override;
+    bool isInside(const ivec2& point) const override { return data.isInside(point); }
+};
+
+class TriangleElement final : public Element {
+    TriangleData data;
 public:
-    TriangleElement(const std::array<float, 2>& v0, const std::array<float, 2>& v1, const std::array<float, 2>& v2, const std::array<float, 3>& color);
-    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override;
-    bool isInside(const ivec2& point) const override;
+    TriangleElement(const std::array<float, 2>& v0, const std::array<float, 2>& v1, const std::array<float, 2>& v2, const std::array<float, 3>& color)
+        : data{v0, v1, v2, color} {}
+    void draw(Screen& screen, const ivec2& start, const ivec2& end) const override { data.draw(screen, start, end); }
+    Rect bounds(const ivec2& start, const ivec2& end) const override { return data.bounds(start, end); }
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const override { data.record(list, start, end); }
+    void storeInto(ElementStore& store) const override;
+    bool isInside(const ivec2& point) const override { return data.isInside(point); }
 };
 
 // Factory Class for Creating Elements
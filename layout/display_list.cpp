@@ -0,0 +1,137 @@
+#include "../all_headers.hpp"
+
+// Colors are stored as bytes, matching the truncation ivec3 applies when drawing directly
+static uint8_t channel(int value) {
+    return static_cast<uint8_t>(value);
+}
+
+void DisplayList::addLine(ivec2 start, ivec2 end, ivec3 color) {
+    commands.push_back({DrawOp::Line, channel(color.x), channel(color.y), channel(color.z),
+                        start.x, start.y, end.x, end.y, 0, 0,
+                        Rect(std::min(start.x, end.x), std::min(start.y, end.y), std::max(start.x, end.x), std::max(start.y, end.y))});
+}
+
+void DisplayList::addBox(ivec2 min, ivec2 max, ivec3 color) {
+    commands.push_back({DrawOp::Box, channel(color.x), channel(color.y), channel(color.z),
+                        min.x, min.y, max.x, max.y, 0, 0,
+                        Rect(std::min(min.x, max.x), std::min(min.y, max.y), std::max(min.x, max.x), std::max(min.y, max.y))});
+}
+
+void DisplayList::addPoint(ivec2 position, ivec3 color) {
+    commands.push_back({DrawOp::Point, channel(color.x), channel(color.y), channel(color.z),
+                        position.x, position.y, 0, 0, 0, 0,
+                        Rect(position.x, position.y, position.x, position.y)});
+}
+
+void DisplayList::addTriangle(ivec2 v0, ivec2 v1, ivec2 v2, ivec3 color) {
+    commands.push_back({DrawOp::Triangle, channel(color.x), channel(color.y), channel(color.z),
+                        v0.x, v0.y, v1.x, v1.y, v2.x, v2.y,
+                        Rect(std::min({v0.x, v1.x, v2.x}), std::min({v0.y, v1.y, v2.y}),
+                             std::max({v0.x, v1.x, v2.x}), std::max({v0.y, v1.y, v2.y}))});
+}
+
+void DisplayList::transform(size_t first, const mat3& matrix, const Rect& clampArea) {
+    if (first >= commands.size()) return;
+
+    // Gather every vertex into two flat arrays. A box contributes its four outer corners:
+    // it covers pixels [min, max], i.e. the area from min to max + 1.
+    xs.clear();
+    ys.clear();
+    for (size_t i = first; i < commands.size(); ++i) {
+        const DrawCommand& command = commands[i];
+        switch (command.op) {
+            case DrawOp::Point:
+                xs.push_back(command.x0);
+                ys.push_back(command.y0);
+                break;
+            case DrawOp::Line:
+                xs.insert(xs.end(), {command.x0, command.x1});
+                ys.insert(ys.end(), {command.y0, command.y1});
+                break;
+            case DrawOp::Triangle:
+                xs.insert(xs.end(), {command.x0, command.x1, command.x2});
+                ys.insert(ys.end(), {command.y0, command.y1, command.y2});
+                break;
+            case DrawOp::Box: {
+                const Rect& box = command.bounds;
+                xs.insert(xs.end(), {box.minX, box.maxX + 1, box.maxX + 1, box.minX});
+                ys.insert(ys.end(), {box.minY, box.minY, box.maxY + 1, box.maxY + 1});
+                break;
+            }
+        }
+    }
+
+    MatrixKernels::transformPoints(matrix.elements(), xs.data(), ys.data(), xs.size());
+
+    // Rebuild the transformed commands from the moved vertices; a rotated box adds a command
+    pending.assign(commands.begin() + first, commands.end());
+    commands.resize(first);
+    bool axisAligned = matrix(0, 1) == 0 && matrix(1, 0) == 0;
+    size_t v = 0;
+    for (const DrawCommand& command : pending) {
+        ivec3 color(command.r, command.g, command.b);
+        switch (command.op) {
+            case DrawOp::Point:
+                addPoint(ivec2(xs[v], ys[v]), color);
+                v += 1;
+                break;
+            case DrawOp::Line:
+                addLine(ivec2(xs[v], ys[v]), ivec2(xs[v + 1], ys[v + 1]), color);
+                v += 2;
+                break;
+            case DrawOp::Triangle:
+                addTriangle(ivec2(xs[v], ys[v]), ivec2(xs[v + 1], ys[v + 1]), ivec2(xs[v + 2], ys[v + 2]), color);
+                v += 3;
+                break;
+            case DrawOp::Box: {
+                ivec2 c0(xs[v], ys[v]), c1(xs[v + 1], ys[v + 1]), c2(xs[v + 2], ys[v + 2]), c3(xs[v + 3], ys[v + 3]);
+                v += 4;
+                if (axisAligned) {
+                    // Opposite outer corners, back to inclusive pixel bounds (also if mirrored)
+                    Rect box = Rect(std::min(c0.x, c2.x), std::min(c0.y, c2.y), std::max(c0.x, c2.x) - 1, std::max(c0.y, c2.y) - 1)
+                                   .intersection(clampArea);
+                    if (!box.empty()) {
+                        addBox(ivec2(box.minX, box.minY), ivec2(box.maxX, box.maxY), color);
+                    }
+                } else {
+                    // The triangle rasterizer's top-left rule keeps the shared diagonal gap-free
+                    addTriangle(c0, c1, c2, color);
+                    addTriangle(c0, c2, c3, color);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void DisplayList::replay(Screen& screen) const {
+    for (const DrawCommand& command : commands) {
+        execute(screen, command);
+    }
+}
+
+void DisplayList::replay(Screen& screen, const Rect& area) const {
+    for (const DrawCommand& command : commands) {
+        if (command.bounds.intersects(area)) {
+            execute(screen, command);
+        }
+    }
+}
+
+void DisplayList::execute(Screen& screen, const DrawCommand& command) {
+    ivec3 color(command.r, command.g, command.b);
+    switch (command.op) {
+        case DrawOp::Line:
+            screen.drawSafeLine(ivec2(command.x0, command.y0), ivec2(command.x1, command.y1), color);
+            break;
+        case DrawOp::Box:
+            screen.drawSafeBox(ivec2(command.x0, command.y0), ivec2(command.x1, command.y1), color);
+            break;
+        case DrawOp::Point:
+            screen.setSafePixel(ivec2(command.x0, command.y0), color);
+            break;
+        case DrawOp::Triangle:
+            screen.drawSafeTriangle(ivec2(command.x0, command.y0), ivec2(command.x1, command.y1), ivec2(command.x2, command.y2), color);
+            break;
+    }
+}
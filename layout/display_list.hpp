@@ -0,0 +1,48 @@
+#ifndef DISPLAY_LIST_HPP
+#define DISPLAY_LIST_HPP
+
+#include "../all_headers.hpp"
+
+enum class DrawOp : uint8_t { Line, Box, Point, Triangle };
+
+// One pre-positioned primitive. Coordinates are final screen pixels: layout offsets,
+// rounding and clamping to the owning layout have already been applied.
+struct DrawCommand {
+    DrawOp op;
+    uint8_t r, g, b;
+    int x0, y0, x1, y1, x2, y2;  // Vertices; unused ones are zero
+    Rect bounds;                 // Screen area the command touches
+};
+
+// Flat command buffer recorded from a Layout tree.
+// Recording walks the tree once (virtual calls, float math); replaying is a tight loop over
+// plain integer commands, so a cached list can be redrawn every frame cheaply.
+class DisplayList {
+public:
+    void clear() { commands.clear(); }
+    size_t size() const { return commands.size(); }
+    const std::vector<DrawCommand>& getCommands() const { return commands; }
+
+    void addLine(ivec2 start, ivec2 end, ivec3 color);
+    void addBox(ivec2 min, ivec2 max, ivec3 color);
+    void addPoint(ivec2 position, ivec3 color);
+    void addTriangle(ivec2 v0, ivec2 v1, ivec2 v2, ivec3 color);
+
+    // Map the vertices of commands [first, size()) through an affine transform in one batched
+    // pass. Boxes stay boxes under scale and translation and are clamped to clampArea (they
+    // were clamped to their layout before); otherwise each becomes two triangles.
+    void transform(size_t first, const mat3& matrix, const Rect& clampArea);
+
+    // Draw every command, or only those overlapping area
+    void replay(Screen& screen) const;
+    void replay(Screen& screen, const Rect& area) const;
+
+    static void execute(Screen& screen, const DrawCommand& command);
+
+private:
+    std::vector<DrawCommand> commands;
+    std::vector<int> xs, ys;             // Vertex scratch for transform
+    std::vector<DrawCommand> pending;    // Commands being rebuilt by transform
+};
+
+#endif // DISPLAY_LIST_HPP
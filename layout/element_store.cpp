@@ -0,0 +1,75 @@
+#include "../all_headers.hpp"
+
+void ElementStore::record(DisplayList& list, const ivec2& start, const ivec2& end) const {
+    for (const ElementRef& ref : order) {
+        switch (ref.kind) {
+            case ElementKind::Line:
+                lines[ref.index].record(list, start, end);
+                break;
+            case ElementKind::Box:
+                boxes[ref.index].record(list, start, end);
+                break;
+            case ElementKind::Point:
+                points[ref.index].record(list, start, end);
+                break;
+            case ElementKind::Triangle:
+                triangles[ref.index].record(list, start, end);
+                break;
+            case ElementKind::Button:
+                buttons[ref.index].record(list, start, end);
+                break;
+        }
+    }
+}
+
+void ElementStore::append(const ElementStore& other) {
+    for (const ElementRef& ref : other.order) {
+        switch (ref.kind) {
+            case ElementKind::Line:
+                add(other.lines[ref.index]);
+                break;
+            case ElementKind::Box:
+                add(other.boxes[ref.index]);
+                break;
+            case ElementKind::Point:
+                add(other.points[ref.index]);
+                break;
+            case ElementKind::Triangle:
+                add(other.triangles[ref.index]);
+                break;
+            case ElementKind::Button:
+                add(other.buttons[ref.index]);
+                break;
+        }
+    }
+}
+
+void ElementStore::reserve(size_t lineCount, size_t boxCount, size_t pointCount, size_t triangleCount) {
+    lines.reserve(lines.size() + lineCount);
+    boxes.reserve(boxes.size() + boxCount);
+    points.reserve(points.size() + pointCount);
+    triangles.reserve(triangles.size() + triangleCount);
+    order.reserve(order.size() + lineCount + boxCount + pointCount + triangleCount);
+}
+
+Rect ElementStore::bounds(const ivec2& start, const ivec2& end) const {
+    // A union does not depend on order, so walk each array straight through
+    Rect area;
+    for (const auto& element : lines) area = area.merged(element.bounds(start, end));
+    for (const auto& element : boxes) area = area.merged(element.bounds(start, end));
+    for (const auto& element : points) area = area.merged(element.bounds(start, end));
+    for (const auto& element : triangles) area = area.merged(element.bounds(start, end));
+    for (const auto& element : buttons) area = area.merged(element.bounds(start, end));
+    return area;
+}
+
+size_t ElementStore::memoryUse() const {
+    return lines.capacity() * sizeof(LineData) + boxes.capacity() * sizeof(BoxData) +
+           points.capacity() * sizeof(PointData) + triangles.capacity() * sizeof(TriangleData) +
+           buttons.capacity() * sizeof(ButtonData) + order.capacity() * sizeof(ElementRef);
+}
+
+// ButtonElement is declared before the store, so its store hook is defined here
+void ButtonElement::storeInto(ElementStore& store) const {
+    store.add(data);
+}
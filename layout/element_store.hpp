@@ -0,0 +1,76 @@
+#ifndef ELEMENT_STORE_HPP
+#define ELEMENT_STORE_HPP
+
+#include "../all_headers.hpp"
+#include "../EventSystem.hpp"
+
+enum class ElementKind : uint8_t { Line, Box, Point, Triangle, Button };
+
+// Position of one element in the store: which array, and where in it
+struct ElementRef {
+    ElementKind kind;
+    uint32_t index;
+};
+
+// Structure-of-arrays storage for a layout's elements.
+// Each primitive type keeps its plain data (LineData, BoxData, ...) by value in its own
+// contiguous array, so adding an element does not allocate it separately, iteration does not
+// chase pointers and no entry carries an Element vptr. A compact list of references keeps the
+// insertion order, which is the order elements are drawn in.
+// The arrays allocate from a std::pmr memory resource: the default heap, or the arena of a
+// layout tree built with Layout::createArenaRoot.
+template <typename T>
+using ElementArray = std::pmr::vector<T>;
+
+class ElementStore {
+public:
+    explicit ElementStore(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : lines(memory), boxes(memory), points(memory), triangles(memory), buttons(memory), order(memory) {}
+
+    void add(const LineData& element) { append(lines, element, ElementKind::Line); }
+    void add(const BoxData& element) { append(boxes, element, ElementKind::Box); }
+    void add(const PointData& element) { append(points, element, ElementKind::Point); }
+    void add(const TriangleData& element) { append(triangles, element, ElementKind::Triangle); }
+    void add(const ButtonData& element) { append(buttons, element, ElementKind::Button); }
+
+    // Append copies of another store's elements, keeping their order
+    void append(const ElementStore& other);
+
+    // Make room for this many more elements of each type, so adding them does not reallocate
+    void reserve(size_t lineCount, size_t boxCount, size_t pointCount, size_t triangleCount);
+
+    size_t size() const { return order.size(); }
+    bool empty() const { return order.empty(); }
+
+    const ElementArray<LineData>& getLines() const { return lines; }
+    const ElementArray<BoxData>& getBoxes() const { return boxes; }
+    const ElementArray<PointData>& getPoints() const { return points; }
+    const ElementArray<TriangleData>& getTriangles() const { return triangles; }
+    const ElementArray<ButtonData>& getButtons() const { return buttons; }
+    ElementArray<ButtonData>& getButtons() { return buttons; }
+
+    // Append every element's commands in insertion order
+    void record(DisplayList& list, const ivec2& start, const ivec2& end) const;
+
+    // Screen area covered by all elements
+    Rect bounds(const ivec2& start, const ivec2& end) const;
+
+    // Bytes reserved by the arrays
+    size_t memoryUse() const;
+
+private:
+    ElementArray<LineData> lines;
+    ElementArray<BoxData> boxes;
+    ElementArray<PointData> points;
+    ElementArray<TriangleData> triangles;
+    ElementArray<ButtonData> buttons;
+    ElementArray<ElementRef> order;
+
+    template <typename T>
+    void append(ElementArray<T>& array, const T& element, ElementKind kind) {
+        order.push_back({kind, static_cast<uint32_t>(array.size())});
+        array.push_back(element);
+    }
+};
+
+#endif // ELEMENT_STORE_HPP
@@ -0,0 +1,63 @@
+#include "../all_headers.hpp"
+
+void HitGrid::clear() {
+    area = Rect();
+    columns = rows = 0;
+    cellStart.clear();
+    indices.clear();
+}
+
+void HitGrid::cellRange(const Rect& hitArea, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const {
+    firstColumn = (hitArea.minX - area.minX) / cellWidth;
+    firstRow = (hitArea.minY - area.minY) / cellHeight;
+    lastColumn = (hitArea.maxX - area.minX) / cellWidth;
+    lastRow = (hitArea.maxY - area.minY) / cellHeight;
+}
+
+void HitGrid::build(const ElementArray<ButtonData>& buttons) {
+    clear();
+
+    std::vector<Rect> hitAreas(buttons.size());
+    for (size_t i = 0; i < buttons.size(); ++i) {
+        hitAreas[i] = buttons[i].hitArea();
+        area = area.merged(hitAreas[i]);
+    }
+    if (area.empty()) return;
+
+    // About one button per cell on average: sqrt(n) cells along each axis
+    int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(buttons.size())))));
+    int width = area.maxX - area.minX + 1;
+    int height = area.maxY - area.minY + 1;
+    cellWidth = std::max(1, (width + side - 1) / side);
+    cellHeight = std::max(1, (height + side - 1) / side);
+    columns = (width + cellWidth - 1) / cellWidth;
+    rows = (height + cellHeight - 1) / cellHeight;
+
+    // Count the buttons per cell, turn the counts into offsets, then fill in index order
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    int firstColumn, firstRow, lastColumn, lastRow;
+    for (const Rect& hitArea : hitAreas) {
+        if (hitArea.empty()) continue;
+        cellRange(hitArea, firstColumn, firstRow, lastColumn, lastRow);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                ++cellStart[static_cast<size_t>(row) * columns + column + 1];
+            }
+        }
+    }
+    for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    indices.resize(cellStart.back());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t index = 0; index < hitAreas.size(); ++index) {
+        if (hitAreas[index].empty()) continue;
+        cellRange(hitAreas[index], firstColumn, firstRow, lastColumn, lastRow);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                indices[fill[static_cast<size_t>(row) * columns + column]++] = index;
+            }
+        }
+    }
+}
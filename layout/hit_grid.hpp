@@ -0,0 +1,41 @@
+#ifndef HIT_GRID_HPP
+#define HIT_GRID_HPP
+
+#include "../all_headers.hpp"
+#include "../EventSystem.hpp"
+#include "element_store.hpp"
+
+// Uniform grid over the hit areas of a layout's buttons.
+// Each cell lists the buttons whose area overlaps it, in ascending index order, so a point
+// query only tests the few buttons sharing its cell and still sees them in insertion order.
+// Cells are stored back to back (one offset per cell into a shared index array).
+class HitGrid {
+public:
+    void build(const ElementArray<ButtonData>& buttons);
+    void clear();
+
+    // Call visit(index) for each button that may contain point, in ascending order, until it
+    // returns true. Returns whether a call returned true.
+    template <typename F>
+    bool query(const ivec2& point, F&& visit) const {
+        if (!area.contains(point.x, point.y)) return false;
+
+        size_t cell = static_cast<size_t>((point.y - area.minY) / cellHeight) * columns + (point.x - area.minX) / cellWidth;
+        for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+            if (visit(indices[i])) return true;
+        }
+        return false;
+    }
+
+private:
+    Rect area;  // Union of all hit areas; empty if there are no buttons
+    int cellWidth = 1, cellHeight = 1;
+    int columns = 0, rows = 0;
+    std::vector<uint32_t> cellStart;  // columns * rows + 1 offsets into indices
+    std::vector<uint32_t> indices;
+
+    // Range of cells a hit area overlaps
+    void cellRange(const Rect& hitArea, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const;
+};
+
+#endif // HIT_GRID_HPP
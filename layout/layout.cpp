@@ -1,81 +1,407 @@
 #include "../all_headers.hpp"
 
 // Layout.cpp
-void Layout::addElement(std::unique_ptr<Element> element) {
-    elements.push_back(std::move(element));
+void Layout::addElement(const Element& element) {
+    markDirty(screenBounds(element));
+    size_t buttonCount = elements.getButtons().size();
+    element.storeInto(elements);
+    if (elements.getButtons().size() != buttonCount) {
+        buttonGridValid = false;
+    }
+    invalidateDisplayList();
+}
+
+void LayoutDeleter::operator()(Layout* layout) const {
+    if (!memory) {
+        delete layout;
+        return;
+    }
+    layout->~Layout();
+    memory->deallocate(layout, sizeof(Layout), alignof(Layout));
+}
+
+std::unique_ptr<Layout> Layout::createArenaRoot(float startX, float startY, float endX, float endY, bool isActive,
+                                                size_t initialBytes) {
+    auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(std::max<size_t>(initialBytes, 1));
+    std::unique_ptr<Layout> root(new Layout(startX, startY, endX, endY, isActive, nullptr, arena.get()));
+    root->arena = std::move(arena);
+    return root;
 }
 
 void Layout::addNestedLayout(std::unique_ptr<Layout> layout) {
     layout->parentLayout = this;
+    if (layout->isActive()) {
+        markDirty(layout->contentBounds());
+    }
+    nestedLayouts.push_back(LayoutPtr(layout.release()));
+    invalidateDisplayList();
+}
+
+// A new layout is empty, so there is nothing to mark dirty yet
+Layout& Layout::createNestedLayout(float startX, float startY, float endX, float endY, bool isActive) {
+    void* block = memory->allocate(sizeof(Layout), alignof(Layout));
+    LayoutPtr layout(new (block) Layout(startX, startY, endX, endY, isActive, this, memory), LayoutDeleter{memory});
+    Layout& created = *layout;
     nestedLayouts.push_back(std::move(layout));
+    invalidateDisplayList();
+    return created;
+}
+
+void Layout::adoptContent(Layout&& source) {
+    Rect area = source.elements.bounds(start, end);
+    if (!source.elements.empty()) {
+        elements.append(source.elements);
+        buttonGridValid = false;
+    }
+    if (source.sound != SoundId::None) {
+        sound = source.sound;
+    }
+    for (auto& nestedLayout : source.nestedLayouts) {
+        nestedLayout->parentLayout = this;
+        nestedLayout->calculatePosition(start, end);
+        if (nestedLayout->isActive()) {
+            area = area.merged(nestedLayout->contentBounds());
+        }
+        nestedLayouts.push_back(std::move(nestedLayout));
+    }
+    source.nestedLayouts.clear();
+    invalidateDisplayList();
+
+    // Element bounds above ignore transforms; with one, repaint everything this layout covers
+    mat3 matrix;
+    markDirty(effectiveTransform(matrix) ? contentBounds() : area);
+}
+
+void Layout::replaceContent(const Layout& source, bool applyActive) {
+    markDirty(contentBounds());
+
+    // Built in this layout's memory, so the move below takes the arrays instead of copying them
+    ElementStore content(memory);
+    content.append(source.elements);
+    for (const ButtonData& button : elements.getButtons()) {
+        content.add(button);
+    }
+    elements = std::move(content);
+    sound = source.sound;
+    if (applyActive) {
+        active = source.active;
+    }
+
+    // Nested layouts only move if this layout's own bounds changed
+    bool moved = sX != source.sX || sY != source.sY || eX != source.eX || eY != source.eY;
+    sX = source.sX;
+    sY = source.sY;
+    eX = source.eX;
+    eY = source.eY;
+    if (moved && parentLayout) {
+        calculatePosition(parentLayout->start, parentLayout->end);
+    } else {
+        invalidateDisplayList();
+        buttonGridValid = false;
+    }
+
+    markDirty(contentBounds());
+}
+
+void Layout::replaceNestedLayouts(std::vector<std::unique_ptr<Layout>> layouts) {
+    for (const auto& nestedLayout : nestedLayouts) {
+        if (nestedLayout->isActive()) {
+            markDirty(nestedLayout->contentBounds());
+        }
+    }
+    nestedLayouts.clear();
+    for (auto& layout : layouts) {
+        nestedLayouts.push_back(LayoutPtr(layout.release()));
+    }
+    for (auto& nestedLayout : nestedLayouts) {
+        nestedLayout->parentLayout = this;
+        nestedLayout->calculatePosition(start, end);
+        if (nestedLayout->isActive()) {
+            markDirty(nestedLayout->contentBounds());
+        }
+    }
+    invalidateDisplayList();
+}
+
+void Layout::setActive(bool state) {
+    if (state == active) return;
+
+    // Showing or hiding only affects the pixels this layout's content covers
+    active = state;
+    invalidateDisplayList();
+    Rect area = contentBounds();
+    if (parentLayout) {
+        parentLayout->markDirty(area);
+    } else {
+        dirtyRegions.push_back(area);
+    }
 }
 
 void Layout::calculatePosition(const ivec2& parentStart, const ivec2& parentEnd) {
+    PROFILE_SCOPE("Layout::calculatePosition");
     ivec2 space = parentEnd - parentStart;
     start = ivec2(static_cast<int>(sX * space.x), static_cast<int>(sY * space.y)) + parentStart;
     end = ivec2(static_cast<int>(eX * space.x), static_cast<int>(eY * space.y)) + parentStart;
+    invalidateDisplayList();
+    updateButtonGrid();
 
     for (auto& nestedLayout : nestedLayouts) {
         nestedLayout->calculatePosition(start, end);
     }
+
+    // Everything may have moved, so the root repaints the whole area it was given
+    if (!parentLayout) {
+        markDirty(Rect(parentStart.x, parentStart.y, parentEnd.x - 1, parentEnd.y - 1));
+    }
 }
 
-void Layout::render(Screen& screen) {
-    if (!active) return;
+void Layout::setTransform(const mat3& matrix) {
+    changeTransform(true, matrix);
+}
+
+void Layout::clearTransform() {
+    changeTransform(false, mat3::identity());
+}
+
+void Layout::changeTransform(bool enabled, const mat3& matrix) {
+    if (enabled == transformed && matrix == transform) return;
+
+    // Repaint where the content was and where it ends up
+    Rect before = active ? contentBounds() : Rect();
+    transformed = enabled;
+    transform = matrix;
+    invalidateDisplayList();
+    invalidateSubtreeDisplayLists();
+    if (active) {
+        markDirty(before.merged(contentBounds()));
+    }
+}
+
+// Screen-space map for this layout's content: its own transform (about its start corner)
+// applied first, then those of its ancestors. Returns false when no layout on the path is
+// transformed, so callers can skip the transform pass entirely.
+bool Layout::effectiveTransform(mat3& result) const {
+    bool any = parentLayout && parentLayout->effectiveTransform(result);
+    if (transformed) {
+        mat3 local = Affine::translate(static_cast<float>(start.x), static_cast<float>(start.y)) * transform *
+                     Affine::translate(static_cast<float>(-start.x), static_cast<float>(-start.y));
+        result = any ? result * local : local;
+        any = true;
+    }
+    return any;
+}
+
+// Screen area given to the root layout; transformed boxes are clamped to it
+Rect Layout::rootArea() const {
+    const Layout* root = this;
+    while (root->parentLayout) {
+        root = root->parentLayout;
+    }
+    return Rect(root->start.x, root->start.y, root->end.x - 1, root->end.y - 1);
+}
+
+Rect Layout::screenBounds(const Element& element) const {
+    mat3 matrix;
+    if (!effectiveTransform(matrix)) {
+        return element.bounds(start, end);
+    }
+
+    DisplayList list;
+    element.record(list, start, end);
+    list.transform(0, matrix, rootArea());
+    Rect area;
+    for (const DrawCommand& command : list.getCommands()) {
+        area = area.merged(command.bounds);
+    }
+    return area;
+}
+
+Rect Layout::contentBounds() const {
+    Rect area;
+    mat3 matrix;
+    if (effectiveTransform(matrix)) {
+        DisplayList list;
+        recordElements(list);
+        for (const DrawCommand& command : list.getCommands()) {
+            area = area.merged(command.bounds);
+        }
+    } else {
+        area = elements.bounds(start, end);
+    }
+    for (const auto& nestedLayout : nestedLayouts) {
+        if (nestedLayout->isActive()) {
+            area = area.merged(nestedLayout->contentBounds());
+        }
+    }
+    return area;
+}
+
+// Record a changed screen area on the root; changes under an inactive layout are invisible
+void Layout::markDirty(const Rect& area) {
+    if (!active || area.empty()) return;
+
+    if (parentLayout) {
+        parentLayout->markDirty(area);
+    } else {
+        dirtyRegions.push_back(area);
+    }
+}
+
+// The cached list of every ancestor includes this layout's commands, so all of them go stale
+void Layout::invalidateDisplayList() {
+    for (Layout* layout = this; layout; layout = layout->parentLayout) {
+        layout->displayListValid = false;
+    }
+}
+
+const DisplayList& Layout::getDisplayList() const {
+    if (!displayListValid) {
+        displayList.clear();
+        recordCommands(displayList);
+        displayListValid = true;
+    }
+    return displayList;
+}
 
-    for (const auto& element : elements) {
-        element->draw(screen, start, end);
+// A transform on an ancestor changes the cached lists of everything below it
+void Layout::invalidateSubtreeDisplayLists() {
+    for (auto& nestedLayout : nestedLayouts) {
+        nestedLayout->displayListValid = false;
+        nestedLayout->invalidateSubtreeDisplayLists();
     }
+}
+
+void Layout::recordCommands(DisplayList& list) const {
+    if (!active) return;
+
+    recordElements(list);
 
     for (const auto& nestedLayout : nestedLayouts) {
-        nestedLayout->render(screen);
+        nestedLayout->recordCommands(list);
+    }
+}
+
+// Record this layout's own elements; if it is transformed, all of their vertices are mapped
+// in one batched pass over the commands just added
+void Layout::recordElements(DisplayList& list) const {
+    size_t first = list.size();
+    elements.record(list, start, end);
+
+    mat3 matrix;
+    if (list.size() > first && effectiveTransform(matrix)) {
+        list.transform(first, matrix, rootArea());
+    }
+}
+
+void Layout::render(Screen& screen) {
+    PROFILE_SCOPE("Layout::render");
+    getDisplayList().replay(screen);
+}
+
+std::vector<Rect> Layout::renderDirty(Screen& screen, const ivec3& background, TileRenderer* tiles) {
+    PROFILE_SCOPE("Layout::renderDirty");
+    // Coalesce overlapping regions so no pixel is repainted twice in one frame
+    std::vector<Rect> regions;
+    for (const Rect& dirty : dirtyRegions) {
+        Rect region = dirty.intersection(screen.bounds());
+        if (region.empty()) continue;
+
+        bool absorbed = true;
+        while (absorbed) {
+            absorbed = false;
+            for (size_t i = 0; i < regions.size(); ++i) {
+                if (regions[i].intersects(region)) {
+                    region = region.merged(regions[i]);
+                    regions[i] = regions.back();
+                    regions.pop_back();
+                    absorbed = true;
+                    break;
+                }
+            }
+        }
+        regions.push_back(region);
+    }
+    dirtyRegions.clear();
+
+    for (const Rect& region : regions) {
+        screen.setClip(region);
+        screen.fillRect(region, background);
+        if (tiles) {
+            tiles->render(*this, screen, region);
+        } else {
+            renderClipped(screen, region);
+        }
     }
+    screen.resetClip();
+    return regions;
+}
+
+// Like render, but skips commands that do not overlap the area being repainted
+void Layout::renderClipped(Screen& screen, const Rect& area) {
+    getDisplayList().replay(screen, area);
+}
+
+void Layout::updateButtonGrid() {
+    buttonGrid.build(elements.getButtons());
+    buttonGridValid = true;
 }
 
 void Layout::handleEvent(const Event& event, SoundPlayer* soundPlayer) {
+    PROFILE_SCOPE("Layout::handleEvent");
+    if (!buttonGridValid) {
+        updateButtonGrid();
+    }
+    ElementArray<ButtonData>& buttons = elements.getButtons();
+    ivec2 point(event.x, event.y);
+
     if (event.type == EventType::CLICK) {
-        for (auto& element : elements) {
-            ButtonElement* button = dynamic_cast<ButtonElement*>(element.get());
-            if (button && button->isClickable() && button->handleEvent(event)) {
-                // Toggle visibility due to CLICK
-                clickToggled = !clickToggled;
-                if (!nestedLayouts.empty()) {
-                    nestedLayouts[0]->setActive(clickToggled);
-                }
-                
-                // Play sound if clickable button is clicked
-                Event soundEvent(EventType::SOUND);
-                propagateEventUp(soundEvent, soundPlayer);
-                return;
+        // The grid hands out candidates in insertion order, so the first hit is the same button a full scan would find
+        bool clicked = buttonGrid.query(point, [&](uint32_t index) {
+            return buttons[index].isClickable() && buttons[index].handleEvent(event);
+        });
+        if (clicked) {
+            // Toggle visibility due to CLICK
+            clickToggled = !clickToggled;
+            if (!nestedLayouts.empty()) {
+                nestedLayouts[0]->setActive(clickToggled);
             }
+
+            // Play sound if clickable button is clicked: this layout's, or the nearest ancestor's
+            const Layout* owner = this;
+            while (owner && owner->sound == SoundId::None) {
+                owner = owner->parentLayout;
+            }
+            Event soundEvent(EventType::SOUND, owner ? owner->sound : SoundId::None);
+            propagateEventUp(soundEvent, soundPlayer);
+            return;
         }
+        // Hidden layouts cannot be clicked, so their subtrees are skipped
         for (auto& nestedLayout : nestedLayouts) {
-            nestedLayout->handleEvent(event, soundPlayer);
+            if (nestedLayout->isActive()) {
+                nestedLayout->handleEvent(event, soundPlayer);
+            }
         }
     } 
     else if (event.type == EventType::SHOW) {
-        bool isHovering = false;
-        for (auto& element : elements) {
-            ButtonElement* button = dynamic_cast<ButtonElement*>(element.get());
-            if (button && button->isHoverable() && button->handleHover(event)) {
-                // Show due to hover only if not already toggled by click
-                if (!clickToggled && !nestedLayouts.empty()) {
-                    nestedLayouts[0]->setActive(true);
-                }
-                isHovering = true;
-                break;
-            }
+        bool isHovering = buttonGrid.query(point, [&](uint32_t index) {
+            return buttons[index].isHoverable() && buttons[index].handleHover(event);
+        });
+        // Show due to hover only if not already toggled by click
+        if (isHovering && !clickToggled && !nestedLayouts.empty()) {
+            nestedLayouts[0]->setActive(true);
         }
         // Hide layout if hover ends and it wasn’t toggled by click
         if (!isHovering && !clickToggled && !nestedLayouts.empty()) {
             nestedLayouts[0]->setActive(false);
         }
         for (auto& nestedLayout : nestedLayouts) {
-            nestedLayout->handleEvent(event, soundPlayer);
+            if (nestedLayout->isActive()) {
+                nestedLayout->handleEvent(event, soundPlayer);
+            }
         }
     } 
     else if (event.type == EventType::SOUND && parentLayout == nullptr) {
-        soundPlayer->playSound();
+        soundPlayer->playSound(event.sound);
     }
 }
 
@@ -84,6 +410,15 @@ void Layout::propagateEventUp(const Event& event, SoundPlayer* soundPlayer) {
     if (parentLayout) {
         parentLayout->propagateEventUp(event, soundPlayer);
     } else if (event.type == EventType::SOUND) {
-        soundPlayer->playSound();
+        soundPlayer->playSound(event.sound);
+    }
+}
+
+void Layout::prefetchSounds(SoundPlayer& soundPlayer) const {
+    if (sound != SoundId::None) {
+        soundPlayer.prefetch(SoundNames::name(sound));
+    }
+    for (const auto& nestedLayout : nestedLayouts) {
+        nestedLayout->prefetchSounds(soundPlayer);
     }
 }
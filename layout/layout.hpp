@@ -4,30 +4,138 @@
 #include "../all_headers.hpp"
 #include "../EventSystem.hpp"
 #include "../SoundPlayer.hpp"
+#include "element_store.hpp"
+#include "hit_grid.hpp"
+
+class TileRenderer;
+class Layout;
+
+// Destroys a nested layout: through the memory resource it was allocated from, or with
+// delete for layouts made with new (memory is null)
+struct LayoutDeleter {
+    std::pmr::memory_resource* memory = nullptr;
+    void operator()(Layout* layout) const;
+};
+using LayoutPtr = std::unique_ptr<Layout, LayoutDeleter>;
 
 class Layout {
 public:
     Layout(float startX, float startY, float endX, float endY, bool isActive = true, Layout* parent = nullptr)
-        : sX(startX), sY(startY), eX(endX), eY(endY), active(isActive), clickToggled(false), parentLayout(parent) {}
+        : Layout(startX, startY, endX, endY, isActive, parent, std::pmr::get_default_resource()) {}
+
+    // Root of a tree kept in a monotonic arena owned by the root. Nested layouts made with
+    // createNestedLayout and the element arrays of the whole tree are carved out of it, and
+    // released in one go when the root is destroyed. initialBytes sizes the first arena block.
+    // Layouts of an arena tree must not be moved into another tree (see adoptContent).
+    static std::unique_ptr<Layout> createArenaRoot(float startX, float startY, float endX, float endY, bool isActive,
+                                                   size_t initialBytes);
 
-    void addElement(std::unique_ptr<Element> element);
+    // Add an empty nested layout allocated from this tree's memory: the arena for arena
+    // trees, the heap otherwise
+    Layout& createNestedLayout(float startX, float startY, float endX, float endY, bool isActive);
+    // Make room for this many more nested layouts and elements of each type
+    void reserveContent(size_t nestedCount, size_t lines, size_t boxes, size_t points, size_t triangles) {
+        nestedLayouts.reserve(nestedLayouts.size() + nestedCount);
+        elements.reserve(lines, boxes, points, triangles);
+    }
+
+    // Elements are copied by value into the layout's ElementStore
+    void addElement(const Element& element);
     void addNestedLayout(std::unique_ptr<Layout> layout);
-    void setActive(bool state) { active = state; }
+    void setActive(bool state);
     bool isActive() const { return active; }
+    const ElementStore& getElements() const { return elements; }
+    size_t getNestedCount() const { return nestedLayouts.size(); }
+    Layout& getNestedLayout(size_t index) { return *nestedLayouts[index]; }
+
+    // Progressive loading: move another layout's elements (appended after this one's) and
+    // nested layouts into this one, which must already be positioned, and take its sound if it
+    // has one. Only the added content is marked dirty. The source must not be an arena tree:
+    // its nested layouts would outlive the arena they live in.
+    void adoptContent(Layout&& source);
+
+    // Hot reload: take the bounds, file elements and sound of a freshly built layout, keeping
+    // this layout's buttons (they are added by code, never by a file) and nested layouts.
+    // The active flag is copied only with applyActive, so hover and click state survive.
+    // In an arena tree the old arrays stay in the arena until the root is destroyed, so each
+    // reload grows it; hot-reloaded trees are meant to live on the heap.
+    void replaceContent(const Layout& source, bool applyActive);
+    // Hot reload: swap the nested layouts for freshly built ones and position them
+    void replaceNestedLayouts(std::vector<std::unique_ptr<Layout>> layouts);
+
+    // Optional affine transform of this layout's content (e.g. from Affine::rotate/scale/translate),
+    // in layout-local pixels: the origin is the layout's start corner, where element
+    // coordinates are measured from. It also applies to nested layouts, on top of their own.
+    // Changing it only re-records the display list; elements are not rebuilt.
+    void setTransform(const mat3& matrix);
+    void clearTransform();
+    bool hasTransform() const { return transformed; }
+
+    // Sound file played when a button in this layout is clicked (from a <sound> tag). Layouts
+    // without one use their nearest ancestor's, and the SoundPlayer's default if none has one.
+    // The name is interned (SoundNames), so clicks pass the sound on as an id.
+    void setSound(std::string_view soundFile) { sound = SoundNames::intern(soundFile); }
+    const std::string& getSound() const { return SoundNames::name(sound); }
+    SoundId getSoundId() const { return sound; }
+    // Start decoding every sound named in this subtree, so the first click does not load it
+    void prefetchSounds(SoundPlayer& soundPlayer) const;
 
     void calculatePosition(const ivec2& parentStart, const ivec2& parentEnd);
     void render(Screen& screen);
     void handleEvent(const Event& event, SoundPlayer* soundPlayer);
     void propagateEventUp(const Event& event, SoundPlayer* soundPlayer);
 
+    // Dirty-rectangle rendering: visible changes record screen regions on the root layout,
+    // and renderDirty repaints only those regions. It returns the repainted rectangles so
+    // the caller can blit and present just those areas; nothing is drawn if nothing changed.
+    bool hasDirtyRegions() const { return !dirtyRegions.empty(); }
+    // With a TileRenderer, each region is rasterized in parallel tiles.
+    std::vector<Rect> renderDirty(Screen& screen, const ivec3& background = ivec3(0, 0, 0), TileRenderer* tiles = nullptr);
+
+    // Commands drawing this layout's active subtree in render order. The list is recorded on
+    // first use and kept until an element is added, a layout is shown or hidden, or positions
+    // are recalculated; render() and renderDirty() replay it.
+    const DisplayList& getDisplayList() const;
+
+    // Screen area covered by this layout's elements and its active nested layouts
+    Rect contentBounds() const;
+
 private:
+    // Only set on an arena root; declared first so it is released after everything built in it
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+    std::pmr::memory_resource* memory;  // Where this layout's elements and nested layouts are allocated
     float sX, sY, eX, eY;
     bool active;
     bool clickToggled;  // Flag to track CLICK toggle state
     ivec2 start, end;
     Layout* parentLayout = nullptr;  // Pointer to parent layout for upward propagation
-    std::vector<std::unique_ptr<Element>> elements;
-    std::vector<std::unique_ptr<Layout>> nestedLayouts;
+    SoundId sound = SoundId::None;
+    ElementStore elements;
+    std::pmr::vector<LayoutPtr> nestedLayouts;
+    std::vector<Rect> dirtyRegions;  // Pending repaint areas; only filled on the root layout
+    mutable DisplayList displayList;
+    mutable bool displayListValid = false;
+    bool transformed = false;
+    mat3 transform = mat3::identity();
+    HitGrid buttonGrid;  // Rebuilt by calculatePosition, or on the next event after a button is added
+    bool buttonGridValid = false;
+
+    Layout(float startX, float startY, float endX, float endY, bool isActive, Layout* parent,
+           std::pmr::memory_resource* resource)
+        : memory(resource), sX(startX), sY(startY), eX(endX), eY(endY), active(isActive), clickToggled(false),
+          parentLayout(parent), elements(resource), nestedLayouts(resource) {}
+
+    void markDirty(const Rect& area);
+    void invalidateDisplayList();
+    void invalidateSubtreeDisplayLists();
+    void recordCommands(DisplayList& list) const;
+    void recordElements(DisplayList& list) const;
+    bool effectiveTransform(mat3& result) const;
+    Rect rootArea() const;
+    Rect screenBounds(const Element& element) const;
+    void changeTransform(bool enabled, const mat3& matrix);
+    void updateButtonGrid();
+    void renderClipped(Screen& screen, const Rect& area);
 };
 
 #endif // LAYOUT_HPP
@@ -0,0 +1,56 @@
+#include "../all_headers.hpp"
+
+void TileRenderer::render(const Layout& root, Screen& screen) {
+    render(root, screen, screen.bounds());
+}
+
+void TileRenderer::render(const Layout& root, Screen& screen, const Rect& area) {
+    PROFILE_SCOPE("TileRenderer::render");
+    Rect target = area.intersection(screen.clipRect());
+    if (target.empty()) return;
+
+    const std::vector<DrawCommand>& commands = root.getDisplayList().getCommands();
+    if (commands.empty()) return;
+
+    // Tile grid covering the target area
+    int tilesX = (target.maxX - target.minX) / tileSize + 1;
+    int tilesY = (target.maxY - target.minY) / tileSize + 1;
+    size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    if (bins.size() < tileCount) {
+        bins.resize(tileCount);
+    }
+    for (size_t i = 0; i < tileCount; ++i) {
+        bins[i].clear();
+    }
+
+    // Bin each command into every tile its clipped bounds overlap; appending in list order
+    // keeps each bin in render order
+    for (uint32_t index = 0; index < commands.size(); ++index) {
+        Rect covered = commands[index].bounds.intersection(target);
+        if (covered.empty()) continue;
+        int firstX = (covered.minX - target.minX) / tileSize;
+        int lastX = (covered.maxX - target.minX) / tileSize;
+        int firstY = (covered.minY - target.minY) / tileSize;
+        int lastY = (covered.maxY - target.minY) / tileSize;
+        for (int ty = firstY; ty <= lastY; ++ty) {
+            for (int tx = firstX; tx <= lastX; ++tx) {
+                bins[static_cast<size_t>(ty) * tilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    pool.parallelFor(tileCount, [&](size_t tile) {
+        const std::vector<uint32_t>& bin = bins[tile];
+        if (bin.empty()) return;
+
+        int tx = static_cast<int>(tile % tilesX);
+        int ty = static_cast<int>(tile / tilesX);
+        int minX = target.minX + tx * tileSize;
+        int minY = target.minY + ty * tileSize;
+        Screen view(screen, Rect(minX, minY, std::min(minX + tileSize - 1, target.maxX), std::min(minY + tileSize - 1, target.maxY)));
+
+        for (uint32_t index : bin) {
+            DisplayList::execute(view, commands[index]);
+        }
+    });
+}
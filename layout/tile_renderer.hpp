@@ -0,0 +1,30 @@
+#ifndef TILE_RENDERER_HPP
+#define TILE_RENDERER_HPP
+
+#include "../all_headers.hpp"
+
+// Multithreaded renderer for a Layout tree.
+// The target area is split into square tiles and every command of the root's display list is
+// binned into the tiles its bounds overlap, keeping render order within each bin. Tiles are then rasterized in parallel
+// on a ThreadPool, each through a Screen view clipped to the tile. Every pixel belongs to one
+// tile and sees the same commands in the same order, so the result is identical to
+// Layout::render.
+class TileRenderer {
+public:
+    explicit TileRenderer(ThreadPool& pool, int tileSize = 64) : pool(pool), tileSize(tileSize) {}
+
+    // Draw the active elements of root that overlap area (the whole screen by default)
+    void render(const Layout& root, Screen& screen);
+    void render(const Layout& root, Screen& screen, const Rect& area);
+
+    int getTileSize() const { return tileSize; }
+
+private:
+    ThreadPool& pool;
+    int tileSize;
+
+    // Reused between frames to avoid reallocating every render
+    std::vector<std::vector<uint32_t>> bins;  // Command indices per tile, in render order
+};
+
+#endif // TILE_RENDERER_HPP
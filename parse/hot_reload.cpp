@@ -0,0 +1,227 @@
+#include "../all_headers.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// 64-bit FNV-1a, fed field by field
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+template <typename T>
+static void hashValue(uint64_t& hash, const T& value) {
+    hashBytes(hash, &value, sizeof(value));
+}
+
+SceneTree::SceneTree(const SceneData& scene)
+    : children(scene.layouts.size()), primitives(scene.layouts.size()), sounds(scene.layouts.size()),
+      ownHash(scene.layouts.size()), subtreeHash(scene.layouts.size()) {
+    for (uint32_t i = 0; i < scene.layouts.size(); ++i) {
+        if (scene.layouts[i].parent != kSceneNoParent) {
+            children[scene.layouts[i].parent].push_back(i);
+        }
+    }
+    for (uint32_t i = 0; i < scene.primitives.size(); ++i) {
+        primitives[scene.primitives[i].layout].push_back(i);
+    }
+    for (const auto& sound : scene.sounds) {
+        sounds[sound.layout] = scene.soundName(sound);
+    }
+
+    // Children come after their parents, so walking backwards finishes them first. Colors
+    // are hashed by value: palette indices shift when an edit adds or removes a color.
+    for (size_t i = scene.layouts.size(); i-- > 0;) {
+        const SceneLayout& layout = scene.layouts[i];
+        uint64_t hash = 14695981039346656037ull;
+        hashValue(hash, layout.sX);
+        hashValue(hash, layout.sY);
+        hashValue(hash, layout.eX);
+        hashValue(hash, layout.eY);
+        hashValue(hash, layout.active);
+        for (uint32_t index : primitives[i]) {
+            const ScenePrimitive& primitive = scene.primitives[index];
+            hashValue(hash, primitive.type);
+            hashValue(hash, primitive.coords);
+            hashValue(hash, scene.colors[primitive.color]);
+        }
+        hashBytes(hash, sounds[i].data(), sounds[i].size());
+        ownHash[i] = hash;
+
+        hashValue(hash, children[i].size());
+        for (uint32_t child : children[i]) {
+            hashValue(hash, subtreeHash[child]);
+        }
+        subtreeHash[i] = hash;
+    }
+}
+
+size_t SceneTree::subtreeSize(uint32_t layout) const {
+    size_t count = 1;
+    for (uint32_t child : children[layout]) {
+        count += subtreeSize(child);
+    }
+    return count;
+}
+
+std::unique_ptr<Layout> buildSceneLayout(const SceneData& scene, const SceneTree& tree, uint32_t layout) {
+    const SceneLayout& desc = scene.layouts[layout];
+    auto built = std::make_unique<Layout>(desc.sX, desc.sY, desc.eX, desc.eY, desc.active != 0);
+    for (uint32_t index : tree.primitives[layout]) {
+        addSceneElement(*built, scene, scene.primitives[index]);
+    }
+    built->setSound(tree.sounds[layout]);
+    return built;
+}
+
+std::unique_ptr<Layout> buildSceneSubtree(const SceneData& scene, const SceneTree& tree, uint32_t layout) {
+    auto built = buildSceneLayout(scene, tree, layout);
+    for (uint32_t child : tree.children[layout]) {
+        built->addNestedLayout(buildSceneSubtree(scene, tree, child));
+    }
+    return built;
+}
+
+// The directory is watched rather than the file, so editors that save by writing a temporary
+// file and renaming it over the original are seen too
+HotReloader::HotReloader(const std::string& fileName, ThreadPool& pool) : fileName(fileName), pool(pool) {
+#ifdef __linux__
+    size_t slash = fileName.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : fileName.substr(0, slash + 1);
+    watchName = slash == std::string::npos ? fileName : fileName.substr(slash + 1);
+
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0 || inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "Cannot watch " << fileName << " for changes" << std::endl;
+        if (watchFd >= 0) {
+            close(watchFd);
+        }
+        watchFd = -1;
+    }
+#endif
+}
+
+HotReloader::~HotReloader() {
+#ifdef __linux__
+    if (watchFd >= 0) {
+        close(watchFd);
+    }
+#endif
+    if (pending.valid()) {
+        pending.wait();
+    }
+}
+
+// Buffered, not mapped: the file may be rewritten while it is being parsed
+std::unique_ptr<HotReloader::ParsedScene> HotReloader::parse(const std::string& fileName) {
+    SceneData scene;
+    Parser parser(fileName, LoadMode::Buffered);
+    if (!parser.parseScene(scene) || scene.layouts.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<ParsedScene>(std::move(scene));
+}
+
+std::unique_ptr<Layout> HotReloader::load() {
+    current = parse(fileName);
+    if (!current) {
+        return nullptr;
+    }
+    return buildSceneSubtree(current->scene, current->tree, 0);
+}
+
+void HotReloader::reload() {
+    if (pending.valid()) {
+        reloadQueued = true;
+    } else {
+        pending = pool.submit([file = fileName] { return parse(file); });
+    }
+}
+
+// Drain the inotify queue; true if any event named the watched file
+bool HotReloader::fileChanged() {
+    bool changed = false;
+#ifdef __linux__
+    if (watchFd < 0) {
+        return false;
+    }
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && watchName == event->name) {
+                changed = true;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+#endif
+    return changed;
+}
+
+bool HotReloader::update(Layout& root) {
+    PROFILE_SCOPE("HotReloader::update");
+    if (fileChanged()) {
+        reload();
+    }
+    if (!pending.valid() || pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+
+    std::unique_ptr<ParsedScene> next = pending.get();
+    if (reloadQueued) {
+        reloadQueued = false;
+        reload();
+    }
+    if (!next || !current) {
+        std::cerr << "Error: " << fileName << " could not be reloaded." << std::endl;
+        ++failedReloads;
+        return false;
+    }
+
+    apply(root, *next, 0, 0);
+    current = std::move(next);
+    ++reloads;
+    return true;
+}
+
+// Walk the old and new trees together below a live layout built from oldLayout
+void HotReloader::apply(Layout& live, const ParsedScene& next, uint32_t oldLayout, uint32_t newLayout) {
+    const SceneTree& before = current->tree;
+    const SceneTree& after = next.tree;
+    if (before.subtreeHash[oldLayout] == after.subtreeHash[newLayout]) {
+        layoutsKept += after.subtreeSize(newLayout);
+        return;
+    }
+
+    if (before.ownHash[oldLayout] != after.ownHash[newLayout]) {
+        // Keep a runtime show/hide unless the file itself changed the active flag
+        bool activeChanged = current->scene.layouts[oldLayout].active != next.scene.layouts[newLayout].active;
+        live.replaceContent(*buildSceneLayout(next.scene, after, newLayout), activeChanged);
+        ++layoutsReplaced;
+    } else {
+        ++layoutsKept;
+    }
+
+    // Children are matched by position; when layouts were added or removed (or added by
+    // code), all of them are rebuilt
+    const std::vector<uint32_t>& oldChildren = before.children[oldLayout];
+    const std::vector<uint32_t>& newChildren = after.children[newLayout];
+    if (oldChildren.size() != newChildren.size() || live.getNestedCount() != oldChildren.size()) {
+        std::vector<std::unique_ptr<Layout>> rebuilt;
+        for (uint32_t child : newChildren) {
+            rebuilt.push_back(buildSceneSubtree(next.scene, after, child));
+            layoutsReplaced += after.subtreeSize(child);
+        }
+        live.replaceNestedLayouts(std::move(rebuilt));
+        return;
+    }
+    for (size_t i = 0; i < newChildren.size(); ++i) {
+        apply(live.getNestedLayout(i), next, oldChildren[i], newChildren[i]);
+    }
+}
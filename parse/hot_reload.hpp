@@ -0,0 +1,89 @@
+#ifndef __HOT_RELOAD_HPP__
+#define __HOT_RELOAD_HPP__
+
+#include "../all_headers.hpp"
+
+// Tree view of a SceneData, with a hash of every layout's own content and of its subtree.
+// Two scenes are diffed by walking both trees from the root: equal subtree hashes mean the
+// whole subtree is unchanged and can be skipped without looking inside it.
+struct SceneTree {
+    std::vector<std::vector<uint32_t>> children;    // Nested layout indices, in file order
+    std::vector<std::vector<uint32_t>> primitives;  // Primitive indices, in file order
+    std::vector<std::string_view> sounds;           // Views into the scene's soundNames
+    std::vector<uint64_t> ownHash;      // Bounds, active flag, elements (with actual colors) and sound
+    std::vector<uint64_t> subtreeHash;  // ownHash combined with the children's subtreeHash
+
+    // The scene must outlive the tree
+    explicit SceneTree(const SceneData& scene);
+
+    // Number of layouts in the subtree rooted at a layout, including it
+    size_t subtreeSize(uint32_t layout) const;
+};
+
+// Build one layout of a scene with its elements and sound, but without nested layouts
+std::unique_ptr<Layout> buildSceneLayout(const SceneData& scene, const SceneTree& tree, uint32_t layout);
+
+// Build the subtree of a scene rooted at a layout
+std::unique_ptr<Layout> buildSceneSubtree(const SceneData& scene, const SceneTree& tree, uint32_t layout);
+
+// Watches a layout file and applies its edits to the live Layout tree.
+// When the file is written (inotify on Linux; call reload() elsewhere), it is re-parsed on
+// the pool. update(), called by the UI thread between frames, diffs the new scene against the
+// one the live tree was built from and replaces only the layouts that changed: unchanged
+// subtrees keep their positions, display lists and hover/click state, and only changed areas
+// are marked dirty. Buttons added by code stay on their layouts.
+//
+// The live tree must be the one returned by load(), optionally with buttons added to it.
+class HotReloader {
+public:
+    HotReloader(const std::string& fileName, ThreadPool& pool);
+    ~HotReloader();
+
+    HotReloader(const HotReloader&) = delete;
+    HotReloader& operator=(const HotReloader&) = delete;
+
+    // Parse the file on the calling thread and build the live tree; nullptr if it cannot be parsed
+    std::unique_ptr<Layout> load();
+
+    // Re-parse the file in the background, as if it had been written
+    void reload();
+
+    // Apply a finished re-parse to the live tree; returns true if the tree was changed
+    bool update(Layout& root);
+
+    // True if file changes are picked up automatically
+    bool isWatching() const { return watchFd >= 0; }
+
+    // Re-parses applied and re-parses that failed; layouts rebuilt and layouts left untouched
+    uint64_t getReloads() const { return reloads; }
+    uint64_t getFailedReloads() const { return failedReloads; }
+    uint64_t getLayoutsReplaced() const { return layoutsReplaced; }
+    uint64_t getLayoutsKept() const { return layoutsKept; }
+
+private:
+    struct ParsedScene {
+        SceneData scene;
+        SceneTree tree;
+        explicit ParsedScene(SceneData&& parsed) : scene(std::move(parsed)), tree(scene) {}
+    };
+
+    std::string fileName;
+    ThreadPool& pool;
+    int watchFd = -1;  // inotify descriptor watching the file's directory
+    std::string watchName;  // File name within that directory
+
+    std::unique_ptr<ParsedScene> current;  // Scene the live tree was built from
+    std::future<std::unique_ptr<ParsedScene>> pending;
+    bool reloadQueued = false;  // The file changed again while it was being parsed
+
+    uint64_t reloads = 0;
+    uint64_t failedReloads = 0;
+    uint64_t layoutsReplaced = 0;
+    uint64_t layoutsKept = 0;
+
+    static std::unique_ptr<ParsedScene> parse(const std::string& fileName);
+    bool fileChanged();
+    void apply(Layout& live, const ParsedScene& next, uint32_t oldLayout, uint32_t newLayout);
+};
+
+#endif // __HOT_RELOAD_HPP__
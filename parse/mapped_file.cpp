@@ -0,0 +1,57 @@
+#include "../all_headers.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : bytes(other.bytes), length(other.length) {
+    other.bytes = nullptr;
+    other.length = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& fileName) {
+    close();
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // The tokenizer reads front to back, so let the kernel read ahead aggressively
+    madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    bytes = static_cast<const char*>(mapping);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        munmap(const_cast<char*>(bytes), length);
+        bytes = nullptr;
+        length = 0;
+    }
+}
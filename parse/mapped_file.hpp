@@ -0,0 +1,32 @@
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+#include "../all_headers.hpp"
+
+// Read-only memory mapping of a whole file.
+// The mapped bytes are exposed as a string_view so they can be parsed in place
+// without being copied into a std::string first.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& fileName) { open(fileName); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file; returns false if it cannot be opened or mapped (e.g. it is empty)
+    bool open(const std::string& fileName);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    std::string_view view() const { return std::string_view(bytes, length); }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+};
+
+#endif // __MAPPED_FILE_HPP__
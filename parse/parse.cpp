@@ -1,194 +1,344 @@
 #include "../all_headers.hpp"
 
-Parser::Parser(const std::string& fileName) {
+Parser::Parser(const std::string& fileName, LoadMode mode) {
+    if (mode == LoadMode::Mapped && mappedFile.open(fileName)) {
+        source = mappedFile.view();
+        return;
+    }
     loadFile(fileName);
 }
 
 void Parser::loadFile(const std::string& fileName) {
-    std::ifstream file(fileName);
-    std::string line;
-    while (std::getline(file, line)) {
-        for (const char& c : line) {
-            if (!std::isspace(c)) {
-                data += c;
-            }
+    // Read the file with a single allocation; the tokenizer handles whitespace itself
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    if (file) {
+        std::streamsize size = file.tellg();
+        if (size > 0) {
+            data.resize(static_cast<size_t>(size));
+            file.seekg(0);
+            file.read(&data[0], size);
+            data.resize(static_cast<size_t>(file.gcount()));
         }
     }
+    source = data;
 }
 
-std::unique_ptr<Layout> Parser::parseRootLayout() {
-    size_t pos = data.find("<layout>");
-    if (pos == std::string::npos) {
+std::unique_ptr<Layout> Parser::parseRootLayout(TreeMemory memory) {
+    PROFILE_SCOPE("Parser::parseRootLayout");
+    SceneData scene;
+    if (!parseScene(scene)) {
         return nullptr;
     }
-    pos += std::string("<layout>").size();
-
-    // Create the root layout with full-screen dimensions (sX=0, sY=0, eX=1, eY=1)
-    auto rootLayout = std::make_unique<Layout>(0, 0, 1, 1, true);
-
-    // Parse child elements within the root layout
-    size_t layoutEnd = data.find("</layout>", pos);
-    while (pos < layoutEnd) {
-        size_t boxPos = findTag("<box>", pos);
-        size_t linePos = findTag("<line>", pos);
-        size_t pointPos = findTag("<point>", pos);
-        size_t trianglePos = findTag("<triangle>", pos);
-        size_t nestedLayoutPos = findTag("<layout>", pos);
-
-        if (nestedLayoutPos < layoutEnd && (nestedLayoutPos < boxPos && nestedLayoutPos < linePos &&
-            nestedLayoutPos < pointPos && nestedLayoutPos < trianglePos)) {
-            pos = nestedLayoutPos + std::string("<layout>").size();
-            rootLayout->addNestedLayout(parseLayout(pos)); // Parse as nested layout with offsets
-        } else if (boxPos < layoutEnd && (boxPos < linePos && boxPos < pointPos && boxPos < trianglePos)) {
-            pos = boxPos + std::string("<box>").size();
-            rootLayout->addElement(parseElement("box", pos));
-        } else if (linePos < layoutEnd && (linePos < pointPos && linePos < trianglePos)) {
-            pos = linePos + std::string("<line>").size();
-            rootLayout->addElement(parseElement("line", pos));
-        } else if (pointPos < layoutEnd && pointPos < trianglePos) {
-            pos = pointPos + std::string("<point>").size();
-            rootLayout->addElement(parseElement("point", pos));
-        } else if (trianglePos < layoutEnd) {
-            pos = trianglePos + std::string("<triangle>").size();
-            rootLayout->addElement(parseElement("triangle", pos));
-        } else {
+    return buildLayoutTree(scene, memory);
+}
+
+std::unique_ptr<Layout> Parser::parseRootLayout(ThreadPool& pool, TreeMemory memory) {
+    PROFILE_SCOPE("Parser::parseRootLayout");
+    SceneData scene;
+    if (!parseSceneParallel(scene, pool)) {
+        return nullptr;
+    }
+    return buildLayoutTree(scene, memory);
+}
+
+// Skip ahead to the first <layout>; anything before it is ignored. Returns its open tag, or
+// an End token if there is none.
+static Token findRootLayout(Tokenizer& tokenizer) {
+    Token token = tokenizer.next();
+    while (token.type != TokenType::End && !(token.type == TokenType::OpenTag && token.value == "layout")) {
+        token = tokenizer.next();
+    }
+    return token;
+}
+
+bool Parser::parseScene(SceneData& scene, const LayoutParsed& onLayout) {
+    if (isBinaryScene(source)) {
+        return readBinaryScene(source, scene);
+    }
+
+    Tokenizer tokenizer(source);
+    Token token = findRootLayout(tokenizer);
+    if (token.type == TokenType::End) {
+        return false;
+    }
+
+    // The root layout always covers the whole screen (sX=0, sY=0, eX=1, eY=1) and is active;
+    // its own offset tags are read but then reset
+    rootScene = &scene;
+    layoutParsed = onLayout ? &onLayout : nullptr;
+    parseLayout(tokenizer, token, scene, kSceneNoParent);
+    scene.layouts[0] = {0, 0, 1, 1, kSceneNoParent, 1};
+    rootScene = nullptr;
+    layoutParsed = nullptr;
+    return true;
+}
+
+// Byte ranges of the layouts nested directly in the root, from the first byte after the root's
+// open tag; stops at the root's close tag. Rather than reading every tag, this jumps from one
+// "layout" to the next (and over comments), which is several times faster than tokenizing.
+static std::vector<std::string_view> findTopLevelLayouts(std::string_view source, size_t from) {
+    const std::string_view name = "layout";
+    std::vector<std::string_view> layouts;
+    size_t depth = 0;
+    size_t layoutStart = 0;
+    auto findComment = [source](size_t start) {
+        // '!' is much rarer than '<', so search for it first
+        for (size_t pos = source.find("!--", start); pos != std::string_view::npos; pos = source.find("!--", pos + 3)) {
+            if (pos > 0 && source[pos - 1] == '<') return pos - 1;
+        }
+        return std::string_view::npos;
+    };
+    size_t comment = findComment(from);
+    for (size_t pos = source.find(name, from); pos != std::string_view::npos; pos = source.find(name, pos)) {
+        if (comment < pos) {
+            size_t close = source.find("-->", comment + 4);
+            if (close == std::string_view::npos) {
+                break;
+            }
+            comment = findComment(close + 3);
+            pos = std::max(pos, close + 3);
+            continue;
+        }
+
+        // Only <layout ...>, <layout/> and </layout> count; not text or longer tag names
+        size_t nameEnd = pos + name.size();
+        bool closing = pos >= 2 && source[pos - 1] == '/' && source[pos - 2] == '<';
+        bool opening = pos >= 1 && source[pos - 1] == '<';
+        size_t tagStart = closing ? pos - 2 : pos - 1;
+        pos = nameEnd;
+        if ((!opening && !closing) || nameEnd == source.size() ||
+            !(source[nameEnd] == '>' || source[nameEnd] == '/' || std::isspace(static_cast<unsigned char>(source[nameEnd])))) {
+            continue;
+        }
+        size_t tagEnd = source.find('>', nameEnd);
+        if (tagEnd == std::string_view::npos) {
             break;
         }
-    }
-    pos = layoutEnd + std::string("</layout>").size();
+        pos = tagEnd + 1;
 
-    return rootLayout;
+        if (closing) {
+            if (depth == 0) {
+                break;  // The root's close tag
+            }
+            if (--depth == 0) {
+                layouts.push_back(source.substr(layoutStart, pos - layoutStart));
+            }
+        } else if (source[tagEnd - 1] == '/') {
+            if (depth == 0) {
+                layouts.push_back(source.substr(tagStart, pos - tagStart));
+            }
+        } else if (depth++ == 0) {
+            layoutStart = tagStart;
+        }
+    }
+    return layouts;
 }
 
-std::unique_ptr<Layout> Parser::parseLayout(size_t& pos) {
-    // Parse offsets only for nested layouts
-    float sX = 0, sY = 0, eX = 1, eY = 1;
-    bool active = false;
-
-    size_t layoutEnd = data.find("</layout>", pos);
-
-    // Parse sX, sY, eX, eY values if they are specified for nested layout
-    size_t sXPos = data.find("<sX>", pos);
-    if (sXPos != std::string::npos && sXPos < layoutEnd) {
-        sXPos += 4;
-        sX = std::stof(data.substr(sXPos, data.find("</sX>", sXPos) - sXPos));
-    }
-
-    size_t sYPos = data.find("<sY>", pos);
-    if (sYPos != std::string::npos && sYPos < layoutEnd) {
-        sYPos += 4;
-        sY = std::stof(data.substr(sYPos, data.find("</sY>", sYPos) - sYPos));
-    }
-
-    size_t eXPos = data.find("<eX>", pos);
-    if (eXPos != std::string::npos && eXPos < layoutEnd) {
-        eXPos += 4;
-        eX = std::stof(data.substr(eXPos, data.find("</eX>", eXPos) - eXPos));
-    }
-
-    size_t eYPos = data.find("<eY>", pos);
-    if (eYPos != std::string::npos && eYPos < layoutEnd) {
-        eYPos += 4;
-        eY = std::stof(data.substr(eYPos, data.find("</eY>", eYPos) - eYPos));
-    }
-
-    // Parse 'active' attribute if it exists in the layout tag
-    size_t activePos = data.find("active=", pos);
-    if (activePos != std::string::npos && activePos < data.find(">", pos)) {
-        active = parseBooleanAttribute("active", pos, true);
-    }
-
-    auto layout = std::make_unique<Layout>(sX, sY, eX, eY, active);
-
-    // Parsing child elements within the nested layout
-    while (pos < layoutEnd) {
-        size_t boxPos = findTag("<box>", pos);
-        size_t linePos = findTag("<line>", pos);
-        size_t pointPos = findTag("<point>", pos);
-        size_t trianglePos = findTag("<triangle>", pos);
-        size_t nestedLayoutPos = findTag("<layout>", pos);
-
-        if (nestedLayoutPos < layoutEnd && (nestedLayoutPos < boxPos && nestedLayoutPos < linePos &&
-            nestedLayoutPos < pointPos && nestedLayoutPos < trianglePos)) {
-            pos = nestedLayoutPos + std::string("<layout>").size();
-            layout->addNestedLayout(parseLayout(pos));
-        } else if (boxPos < layoutEnd && (boxPos < linePos && boxPos < pointPos && boxPos < trianglePos)) {
-            pos = boxPos + std::string("<box>").size();
-            layout->addElement(parseElement("box", pos));
-        } else if (linePos < layoutEnd && (linePos < pointPos && linePos < trianglePos)) {
-            pos = linePos + std::string("<line>").size();
-            layout->addElement(parseElement("line", pos));
-        } else if (pointPos < layoutEnd && pointPos < trianglePos) {
-            pos = pointPos + std::string("<point>").size();
-            layout->addElement(parseElement("point", pos));
-        } else if (trianglePos < layoutEnd) {
-            pos = trianglePos + std::string("<triangle>").size();
-            layout->addElement(parseElement("triangle", pos));
+// The top-level layouts, and the stretches of root content between them, are parsed on the
+// pool, each into a scene of its own. These are then appended in file order, so the result is
+// identical to parseScene's.
+bool Parser::parseSceneParallel(SceneData& scene, ThreadPool& pool) {
+    if (isBinaryScene(source)) {
+        return readBinaryScene(source, scene);
+    }
+
+    Tokenizer tokenizer(source);
+    Token token = findRootLayout(tokenizer);
+    if (token.type == TokenType::End) {
+        return false;
+    }
+    size_t bodyStart = tokenizer.position();
+    bool selfClosing = source[bodyStart - 2] == '/';
+    std::vector<std::string_view> layouts;
+    if (!selfClosing) {
+        PROFILE_SCOPE("Parser::findTopLevelLayouts");
+        layouts = findTopLevelLayouts(source, bodyStart);
+    }
+    if (layouts.size() < 2) {
+        return parseScene(scene);
+    }
+
+    // Units alternate between the root's own content and a top-level layout: root content
+    // before layout 0, layout 0, root content before layout 1, ..., the rest of the root
+    std::vector<std::string_view> units;
+    size_t pos = bodyStart;
+    for (std::string_view layout : layouts) {
+        size_t layoutStart = static_cast<size_t>(layout.data() - source.data());
+        units.push_back(source.substr(pos, layoutStart - pos));
+        units.push_back(layout);
+        pos = layoutStart + layout.size();
+    }
+    units.push_back(source.substr(pos));  // parseLayoutBody stops at the root's close tag
+
+    std::vector<SceneData> parsed(units.size());
+    pool.parallelFor(units.size(), [&](size_t i) {
+        Tokenizer unitTokenizer(units[i]);
+        if (i % 2 == 1) {
+            parseLayout(unitTokenizer, unitTokenizer.next(), parsed[i], kSceneNoParent);
         } else {
-            break;
+            parsed[i].layouts.push_back({0, 0, 1, 1, kSceneNoParent, 1});
+            parseLayoutBody(unitTokenizer, parsed[i], 0);
+        }
+    });
+
+    // Stitch in file order; colors are re-indexed in order of first use, as a serial parse adds them
+    scene.layouts.push_back({0, 0, 1, 1, kSceneNoParent, 1});
+    for (size_t i = 0; i < units.size(); ++i) {
+        const SceneData& unit = parsed[i];
+        if (i % 2 == 1) {
+            appendSubScene(scene, unit, 0);
+            continue;
+        }
+        for (ScenePrimitive primitive : unit.primitives) {
+            primitive.color = scene.addColor(unit.colors[primitive.color]);
+            scene.primitives.push_back(primitive);
+        }
+        for (const SceneSound& sound : unit.sounds) {
+            scene.addSound(0, unit.soundName(sound));
         }
     }
+    return true;
+}
+
+void Parser::parseLayout(Tokenizer& tokenizer, const Token& openTag, SceneData& scene, uint32_t parent) {
+    uint32_t layoutIndex = static_cast<uint32_t>(scene.layouts.size());
+    bool active = parseBooleanAttribute(openTag.attributes, "active", false);
+    scene.layouts.push_back({0, 0, 1, 1, parent, active ? 1u : 0u});
+    parseLayoutBody(tokenizer, scene, layoutIndex);
+}
 
-    pos = layoutEnd + std::string("</layout>").size();
+void Parser::parseLayoutBody(Tokenizer& tokenizer, SceneData& scene, uint32_t layoutIndex) {
+    for (Token token = tokenizer.next(); token.type != TokenType::End; token = tokenizer.next()) {
+        if (token.type == TokenType::CloseTag && token.value == "layout") {
+            return;
+        }
+        if (token.type != TokenType::OpenTag) {
+            continue;
+        }
 
-    return layout;
+        // Index instead of holding a reference: nested layouts may grow scene.layouts
+        if (token.value == "layout" && layoutParsed && &scene == rootScene && layoutIndex == 0) {
+            // A top-level layout is parsed on its own so it can be handed out before the rest
+            SceneData layout;
+            parseLayout(tokenizer, token, layout, kSceneNoParent);
+            (*layoutParsed)(scene, layout);
+            appendSubScene(scene, layout, layoutIndex);
+        } else if (token.value == "layout") {
+            parseLayout(tokenizer, token, scene, layoutIndex);
+        } else if (token.value == "sX") {
+            scene.layouts[layoutIndex].sX = parseFloat(parseText(tokenizer), scene.layouts[layoutIndex].sX);
+        } else if (token.value == "sY") {
+            scene.layouts[layoutIndex].sY = parseFloat(parseText(tokenizer), scene.layouts[layoutIndex].sY);
+        } else if (token.value == "eX") {
+            scene.layouts[layoutIndex].eX = parseFloat(parseText(tokenizer), scene.layouts[layoutIndex].eX);
+        } else if (token.value == "eY") {
+            scene.layouts[layoutIndex].eY = parseFloat(parseText(tokenizer), scene.layouts[layoutIndex].eY);
+        } else if (token.value == "active") {
+            scene.layouts[layoutIndex].active = (parseText(tokenizer) == "true") ? 1u : 0u;
+        } else if (token.value == "sound") {
+            scene.addSound(layoutIndex, parseText(tokenizer));
+        } else if (token.value == "box" || token.value == "line" || token.value == "point" || token.value == "triangle") {
+            parseElement(token.value, tokenizer, scene, layoutIndex);
+        }
+    }
 }
 
-std::unique_ptr<Element> Parser::parseElement(const std::string& type, size_t& pos) {
+void Parser::parseElement(std::string_view type, Tokenizer& tokenizer, SceneData& scene, uint32_t layoutIndex) {
+    ScenePrimitive primitive{};
+    primitive.layout = layoutIndex;
     if (type == "box") {
-        auto min = parseVec2(pos);
-        auto max = parseVec2(pos);
-        auto color = parseVec3(pos);
-        return ElementFactory::createBox(min, max, color);
+        primitive.type = PrimitiveType::Box;
     } else if (type == "line") {
-        auto start = parseVec2(pos);
-        auto end = parseVec2(pos);
-        auto color = parseVec3(pos);
-        return ElementFactory::createLine(start, end, color);
+        primitive.type = PrimitiveType::Line;
     } else if (type == "point") {
-        auto position = parseVec2(pos);
-        auto color = parseVec3(pos);
-        return ElementFactory::createPoint(position, color);
-    } else if (type == "triangle") {
-        auto v0 = parseVec2(pos);
-        auto v1 = parseVec2(pos);
-        auto v2 = parseVec2(pos);
-        auto color = parseVec3(pos);
-        return ElementFactory::createTriangle(v0, v1, v2, color);
-    }
-    return nullptr;
+        primitive.type = PrimitiveType::Point;
+    } else {
+        primitive.type = PrimitiveType::Triangle;
+    }
+
+    // Collect the element's vertices and color in document order
+    std::array<float, 3> color{};
+    size_t pointCount = 0;
+
+    for (Token token = tokenizer.next(); token.type != TokenType::End; token = tokenizer.next()) {
+        if (token.type == TokenType::CloseTag && token.value == type) {
+            break;
+        }
+        if (token.type != TokenType::OpenTag) {
+            continue;
+        }
+        if (token.value == "vec2") {
+            auto point = parseVec2(tokenizer);
+            if (pointCount < 3) {
+                primitive.coords[pointCount * 2] = point[0];
+                primitive.coords[pointCount * 2 + 1] = point[1];
+                ++pointCount;
+            }
+        } else if (token.value == "vec3") {
+            color = parseVec3(tokenizer);
+        }
+    }
+
+    primitive.color = scene.addColor(color);
+    scene.primitives.push_back(primitive);
 }
 
-std::array<float, 2> Parser::parseVec2(size_t& pos) {
-    std::array<float, 2> vec;
-    pos = data.find("<x>", pos) + 3;
-    vec[0] = std::stof(data.substr(pos, data.find("</x>", pos) - pos));
-    pos = data.find("<y>", pos) + 3;
-    vec[1] = std::stof(data.substr(pos, data.find("</y>", pos) - pos));
+std::array<float, 2> Parser::parseVec2(Tokenizer& tokenizer) {
+    std::array<float, 2> vec{};
+    for (Token token = tokenizer.next(); token.type != TokenType::End; token = tokenizer.next()) {
+        if (token.type == TokenType::CloseTag && token.value == "vec2") {
+            break;
+        }
+        if (token.type == TokenType::OpenTag && token.value == "x") {
+            vec[0] = parseFloat(parseText(tokenizer));
+        } else if (token.type == TokenType::OpenTag && token.value == "y") {
+            vec[1] = parseFloat(parseText(tokenizer));
+        }
+    }
     return vec;
 }
 
-std::array<float, 3> Parser::parseVec3(size_t& pos) {
-    std::array<float, 3> vec;
-    pos = data.find("<x>", pos) + 3;
-    vec[0] = std::stof(data.substr(pos, data.find("</x>", pos) - pos));
-    pos = data.find("<y>", pos) + 3;
-    vec[1] = std::stof(data.substr(pos, data.find("</y>", pos) - pos));
-    pos = data.find("<z>", pos) + 3;
-    vec[2] = std::stof(data.substr(pos, data.find("</z>", pos) - pos));
+std::array<float, 3> Parser::parseVec3(Tokenizer& tokenizer) {
+    std::array<float, 3> vec{};
+    for (Token token = tokenizer.next(); token.type != TokenType::End; token = tokenizer.next()) {
+        if (token.type == TokenType::CloseTag && token.value == "vec3") {
+            break;
+        }
+        if (token.type == TokenType::OpenTag && token.value == "x") {
+            vec[0] = parseFloat(parseText(tokenizer));
+        } else if (token.type == TokenType::OpenTag && token.value == "y") {
+            vec[1] = parseFloat(parseText(tokenizer));
+        } else if (token.type == TokenType::OpenTag && token.value == "z") {
+            vec[2] = parseFloat(parseText(tokenizer));
+        }
+    }
     return vec;
 }
 
-bool Parser::parseBooleanAttribute(const std::string& attributeName, size_t pos, bool defaultValue) {
-    size_t attrPos = data.find(attributeName + "=\"", pos);
-    if (attrPos != std::string::npos && attrPos < data.find(">", pos)) {
-        attrPos += attributeName.size() + 2;
-        std::string value = data.substr(attrPos, data.find("\"", attrPos) - attrPos);
-        return (value == "true");
+// Read the text content of a simple <tag>value</tag> pair; the open tag has already been consumed.
+// Mismatched close tags (e.g. <y>100</x>) are tolerated: the first close tag ends the value.
+std::string_view Parser::parseText(Tokenizer& tokenizer) {
+    std::string_view text;
+    for (Token token = tokenizer.next(); token.type != TokenType::End; token = tokenizer.next()) {
+        if (token.type == TokenType::Text) {
+            text = token.value;
+        } else if (token.type == TokenType::CloseTag || token.type == TokenType::OpenTag) {
+            break;
+        }
     }
-    return defaultValue;
+    return text;
 }
 
-size_t Parser::findTag(const std::string& tag, size_t pos) {
-    return data.find(tag, pos);
+bool Parser::parseBooleanAttribute(std::string_view attributes, std::string_view attributeName, bool defaultValue) {
+    size_t attrPos = attributes.find(attributeName);
+    while (attrPos != std::string_view::npos) {
+        size_t valuePos = attrPos + attributeName.size();
+        if (attributes.compare(valuePos, 2, "=\"") == 0) {
+            valuePos += 2;
+            size_t valueEnd = attributes.find('"', valuePos);
+            return attributes.substr(valuePos, valueEnd - valuePos) == "true";
+        }
+        attrPos = attributes.find(attributeName, valuePos);
+    }
+    return defaultValue;
 }
@@ -3,25 +3,60 @@
 
 #include "../all_headers.hpp"
 
+// How Parser brings the file into memory
+enum class LoadMode {
+    Buffered,  // Read the whole file into an owned string
+    Mapped     // mmap the file and parse the mapped bytes in place (falls back to Buffered on failure)
+};
+
 class Parser {
 public:
-    Parser(const std::string& fileName);
-    std::unique_ptr<Layout> parseRootLayout();
+    Parser(const std::string& fileName, LoadMode mode = LoadMode::Buffered);
+
+    // source views the parser's own data or mappedFile, so a copy or move would leave it
+    // pointing into the other object
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+    Parser(Parser&&) = delete;
+    Parser& operator=(Parser&&) = delete;
+
+    // With TreeMemory::Arena the whole tree is built in one arena owned by the root
+    std::unique_ptr<Layout> parseRootLayout(TreeMemory memory = TreeMemory::Heap);
+    // Same result, parsing the top-level layouts in parallel (see parseSceneParallel)
+    std::unique_ptr<Layout> parseRootLayout(ThreadPool& pool, TreeMemory memory = TreeMemory::Heap);
+
+    // Called for each layout nested directly in the root as soon as its close tag is read,
+    // with the scene parsed so far and the new layout's subtree as a scene of its own (its
+    // layout 0). The subtree is added to the scene right after the call.
+    using LayoutParsed = std::function<void(const SceneData& scene, const SceneData& layout)>;
+
+    // Parse the file into a flat scene; accepts XML or a compiled binary scene. Binary scenes
+    // are read in one go and do not report layouts to onLayout.
+    bool parseScene(SceneData& scene, const LayoutParsed& onLayout = nullptr);
+
+    // Parse an XML file with the layouts nested directly in the root spread over the pool.
+    // A quick scan of the tags finds where each of them starts and ends first. The scene is
+    // the same as parseScene's; files with fewer than two such layouts are parsed serially.
+    bool parseSceneParallel(SceneData& scene, ThreadPool& pool);
 
 private:
-    std::string data;  // The entire XML content in a single string for easy parsing
+    std::string data;         // File content when loaded in Buffered mode
+    MappedFile mappedFile;    // File mapping when loaded in Mapped mode
+    std::string_view source;  // The file being parsed; views either data or mappedFile
+    const SceneData* rootScene = nullptr;       // Scene whose layout 0 is the root, while parsing
+    const LayoutParsed* layoutParsed = nullptr;  // Set while parseScene streams top-level layouts
     void loadFile(const std::string& fileName);
-    
-    // Parse methods
-    std::unique_ptr<Layout> parseLayout(size_t& pos);
-    std::unique_ptr<Element> parseElement(const std::string& type, size_t& pos);
-    
+
+    // Parse methods; each consumes tokens up to and including the matching close tag
+    void parseLayout(Tokenizer& tokenizer, const Token& openTag, SceneData& scene, uint32_t parent);
+    void parseLayoutBody(Tokenizer& tokenizer, SceneData& scene, uint32_t layoutIndex);
+    void parseElement(std::string_view type, Tokenizer& tokenizer, SceneData& scene, uint32_t layoutIndex);
+
     // Helper methods to parse specific data
-    std::array<float, 2> parseVec2(size_t& pos);
-    std::array<float, 3> parseVec3(size_t& pos);
-    bool parseBooleanAttribute(const std::string& attributeName, size_t pos, bool defaultValue);
-    
-    size_t findTag(const std::string& tag, size_t pos);
+    std::array<float, 2> parseVec2(Tokenizer& tokenizer);
+    std::array<float, 3> parseVec3(Tokenizer& tokenizer);
+    std::string_view parseText(Tokenizer& tokenizer);
+    bool parseBooleanAttribute(std::string_view attributes, std::string_view attributeName, bool defaultValue);
 };
 
 #endif // __PARSE_HPP__
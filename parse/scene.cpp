@@ -0,0 +1,227 @@
+#include "../all_headers.hpp"
+
+size_t SceneColorHash::operator()(const std::array<float, 3>& color) const {
+    size_t hash = 0;
+    for (float component : color) {
+        hash = hash * 31 + std::hash<float>()(component);
+    }
+    return hash;
+}
+
+uint32_t SceneData::addColor(const std::array<float, 3>& color) {
+    auto found = colorIndex.find(color);
+    if (found != colorIndex.end()) {
+        return found->second;
+    }
+    uint32_t index = static_cast<uint32_t>(colors.size());
+    colors.push_back(color);
+    colorIndex.emplace(color, index);
+    return index;
+}
+
+void SceneData::addSound(uint32_t layout, std::string_view fileName) {
+    sounds.push_back({layout, static_cast<uint32_t>(soundNames.size()), static_cast<uint32_t>(fileName.size())});
+    soundNames.append(fileName);
+}
+
+bool isBinaryScene(std::string_view bytes) {
+    return bytes.size() >= sizeof(kSceneMagic) && bytes.compare(0, sizeof(kSceneMagic), std::string_view(kSceneMagic, sizeof(kSceneMagic))) == 0;
+}
+
+bool writeBinaryScene(const SceneData& scene, const std::string& fileName) {
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    SceneHeader header;
+    std::memcpy(header.magic, kSceneMagic, sizeof(header.magic));
+    header.version = kSceneVersion;
+    header.layoutCount = static_cast<uint32_t>(scene.layouts.size());
+    header.primitiveCount = static_cast<uint32_t>(scene.primitives.size());
+    header.colorCount = static_cast<uint32_t>(scene.colors.size());
+    header.soundCount = static_cast<uint32_t>(scene.sounds.size());
+    header.soundNameBytes = static_cast<uint32_t>(scene.soundNames.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(scene.layouts.data()), scene.layouts.size() * sizeof(SceneLayout));
+    file.write(reinterpret_cast<const char*>(scene.primitives.data()), scene.primitives.size() * sizeof(ScenePrimitive));
+    file.write(reinterpret_cast<const char*>(scene.colors.data()), scene.colors.size() * sizeof(std::array<float, 3>));
+    file.write(reinterpret_cast<const char*>(scene.sounds.data()), scene.sounds.size() * sizeof(SceneSound));
+    file.write(scene.soundNames.data(), scene.soundNames.size());
+    return static_cast<bool>(file);
+}
+
+// Copy count records of T out of the byte stream, advancing pos; fails if the stream is too short
+template <typename T>
+static bool readArray(std::string_view bytes, size_t& pos, uint32_t count, std::vector<T>& out) {
+    size_t size = static_cast<size_t>(count) * sizeof(T);
+    if (bytes.size() - pos < size) {
+        return false;
+    }
+    out.resize(count);
+    std::memcpy(out.data(), bytes.data() + pos, size);
+    pos += size;
+    return true;
+}
+
+bool readBinaryScene(std::string_view bytes, SceneData& scene) {
+    SceneHeader header{};
+    if (bytes.size() < kSceneHeaderSizeV1 || !isBinaryScene(bytes)) {
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), kSceneHeaderSizeV1);
+    size_t headerSize = header.version == 1 ? kSceneHeaderSizeV1 : sizeof(header);
+    if (header.version < 1 || header.version > kSceneVersion) {
+        std::cerr << "Error: unsupported scene version " << header.version << std::endl;
+        return false;
+    }
+    if (bytes.size() < headerSize) {
+        std::cerr << "Error: scene file is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), headerSize);
+
+    size_t pos = headerSize;
+    std::vector<char> names;
+    if (!readArray(bytes, pos, header.layoutCount, scene.layouts) ||
+        !readArray(bytes, pos, header.primitiveCount, scene.primitives) ||
+        !readArray(bytes, pos, header.colorCount, scene.colors) ||
+        !readArray(bytes, pos, header.soundCount, scene.sounds) ||
+        !readArray(bytes, pos, header.soundNameBytes, names)) {
+        std::cerr << "Error: scene file is truncated" << std::endl;
+        return false;
+    }
+    scene.soundNames.assign(names.begin(), names.end());
+
+    // Reject indices that would point outside the arrays
+    for (size_t i = 0; i < scene.layouts.size(); ++i) {
+        uint32_t parent = scene.layouts[i].parent;
+        if ((i == 0) != (parent == kSceneNoParent) || (i != 0 && parent >= i)) {
+            std::cerr << "Error: scene layout " << i << " has an invalid parent" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& primitive : scene.primitives) {
+        if (primitive.layout >= header.layoutCount || primitive.color >= header.colorCount ||
+            static_cast<uint32_t>(primitive.type) > static_cast<uint32_t>(PrimitiveType::Triangle)) {
+            std::cerr << "Error: scene primitive references invalid data" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& sound : scene.sounds) {
+        if (sound.layout >= header.layoutCount || sound.nameOffset > scene.soundNames.size() ||
+            sound.nameLength > scene.soundNames.size() - sound.nameOffset) {
+            std::cerr << "Error: scene sound references invalid data" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void appendSubScene(SceneData& scene, const SceneData& subScene, uint32_t parent) {
+    uint32_t layoutOffset = static_cast<uint32_t>(scene.layouts.size());
+    for (SceneLayout layout : subScene.layouts) {
+        layout.parent = layout.parent == kSceneNoParent ? parent : layout.parent + layoutOffset;
+        scene.layouts.push_back(layout);
+    }
+
+    // Palettes are de-duplicated, so colors are looked up rather than offset
+    std::vector<uint32_t> colorMap(subScene.colors.size());
+    for (size_t i = 0; i < subScene.colors.size(); ++i) {
+        colorMap[i] = scene.addColor(subScene.colors[i]);
+    }
+    for (ScenePrimitive primitive : subScene.primitives) {
+        primitive.layout += layoutOffset;
+        primitive.color = colorMap[primitive.color];
+        scene.primitives.push_back(primitive);
+    }
+
+    for (const SceneSound& sound : subScene.sounds) {
+        scene.addSound(sound.layout + layoutOffset, subScene.soundName(sound));
+    }
+}
+
+void addSceneElement(Layout& layout, const SceneData& scene, const ScenePrimitive& primitive) {
+    const float* c = primitive.coords;
+    const auto& color = scene.colors[primitive.color];
+    switch (primitive.type) {
+        case PrimitiveType::Line:
+            layout.addElement(LineElement({c[0], c[1]}, {c[2], c[3]}, color));
+            break;
+        case PrimitiveType::Box:
+            layout.addElement(BoxElement({c[0], c[1]}, {c[2], c[3]}, color));
+            break;
+        case PrimitiveType::Point:
+            layout.addElement(PointElement({c[0], c[1]}, color));
+            break;
+        case PrimitiveType::Triangle:
+            layout.addElement(TriangleElement({c[0], c[1]}, {c[2], c[3]}, {c[4], c[5]}, color));
+            break;
+    }
+}
+
+// Per-layout counts, so every array is allocated once at its final size
+struct LayoutContent {
+    size_t nested = 0;
+    size_t primitives[4] = {};  // Indexed by PrimitiveType
+};
+
+// Arena bytes for the whole tree, with some slack for block headers and alignment
+static size_t arenaSize(const std::vector<LayoutContent>& content) {
+    // The element types ElementStore keeps in its arrays
+    static const size_t elementSizes[4] = {sizeof(LineData), sizeof(BoxData), sizeof(PointData), sizeof(TriangleData)};
+    size_t bytes = 0;
+    for (const LayoutContent& layout : content) {
+        bytes += sizeof(Layout) + layout.nested * sizeof(LayoutPtr);
+        for (size_t type = 0; type < 4; ++type) {
+            bytes += layout.primitives[type] * (elementSizes[type] + sizeof(ElementRef));
+        }
+    }
+    return bytes + bytes / 8 + 4096;
+}
+
+std::unique_ptr<Layout> buildLayoutTree(const SceneData& scene, TreeMemory memory) {
+    if (scene.layouts.empty()) {
+        return nullptr;
+    }
+
+    std::vector<LayoutContent> content(scene.layouts.size());
+    for (const auto& desc : scene.layouts) {
+        if (desc.parent != kSceneNoParent) {
+            ++content[desc.parent].nested;
+        }
+    }
+    for (const auto& primitive : scene.primitives) {
+        ++content[primitive.layout].primitives[static_cast<size_t>(primitive.type)];
+    }
+
+    // Layouts are stored parents-first, so each parent exists before its children are attached
+    std::vector<Layout*> layouts(scene.layouts.size());
+    std::unique_ptr<Layout> root;
+    for (size_t i = 0; i < scene.layouts.size(); ++i) {
+        const SceneLayout& desc = scene.layouts[i];
+        bool active = desc.active != 0;
+        if (desc.parent != kSceneNoParent) {
+            layouts[i] = &layouts[desc.parent]->createNestedLayout(desc.sX, desc.sY, desc.eX, desc.eY, active);
+        } else if (memory == TreeMemory::Arena) {
+            root = Layout::createArenaRoot(desc.sX, desc.sY, desc.eX, desc.eY, active, arenaSize(content));
+            layouts[i] = root.get();
+        } else {
+            root = std::make_unique<Layout>(desc.sX, desc.sY, desc.eX, desc.eY, active);
+            layouts[i] = root.get();
+        }
+        const LayoutContent& counts = content[i];
+        layouts[i]->reserveContent(counts.nested, counts.primitives[0], counts.primitives[1], counts.primitives[2],
+                                   counts.primitives[3]);
+    }
+
+    for (const auto& primitive : scene.primitives) {
+        addSceneElement(*layouts[primitive.layout], scene, primitive);
+    }
+
+    for (const auto& sound : scene.sounds) {
+        layouts[sound.layout]->setSound(scene.soundName(sound));
+    }
+    return root;
+}
@@ -0,0 +1,103 @@
+#ifndef __SCENE_HPP__
+#define __SCENE_HPP__
+
+#include "../all_headers.hpp"
+
+// Flat, pointer-free description of a layout tree.
+// The XML parser fills one of these, the binary scene format stores one verbatim,
+// and buildLayoutTree() turns it into the Layout/Element tree used for rendering.
+
+constexpr uint32_t kSceneNoParent = 0xFFFFFFFFu;
+
+struct SceneLayout {
+    float sX, sY, eX, eY;
+    uint32_t parent;  // Index of the parent layout, kSceneNoParent for the root
+    uint32_t active;  // 0 or 1; 32-bit so the struct has no padding on disk
+};
+
+enum class PrimitiveType : uint32_t { Line, Box, Point, Triangle };
+
+struct ScenePrimitive {
+    PrimitiveType type;
+    uint32_t layout;   // Index of the owning layout
+    uint32_t color;    // Index into SceneData::colors
+    float coords[6];   // Up to three (x, y) vertices; unused slots are zero
+};
+
+// Sound played when a button in the layout (or a nested layout without its own) is clicked
+struct SceneSound {
+    uint32_t layout;      // Index of the layout
+    uint32_t nameOffset;  // File name: SceneData::soundNames, nameLength bytes from nameOffset
+    uint32_t nameLength;
+};
+
+// Hash for de-duplicating colors in the palette
+struct SceneColorHash {
+    size_t operator()(const std::array<float, 3>& color) const;
+};
+
+struct SceneData {
+    std::vector<SceneLayout> layouts;  // Parents always come before their children
+    std::vector<ScenePrimitive> primitives;
+    std::vector<std::array<float, 3>> colors;
+    std::vector<SceneSound> sounds;
+    std::string soundNames;  // The sound file names, back to back
+
+    // Return the palette index of a color, adding it if it is new
+    uint32_t addColor(const std::array<float, 3>& color);
+
+    // Set the sound of a layout
+    void addSound(uint32_t layout, std::string_view fileName);
+    std::string_view soundName(const SceneSound& sound) const {
+        return std::string_view(soundNames).substr(sound.nameOffset, sound.nameLength);
+    }
+
+private:
+    std::unordered_map<std::array<float, 3>, uint32_t, SceneColorHash> colorIndex;
+};
+
+// Binary scene file layout (version 2, little-endian):
+//   SceneHeader, then layoutCount SceneLayouts, primitiveCount ScenePrimitives,
+//   colorCount float[3] colors, soundCount SceneSounds and soundNameBytes of soundNames,
+//   each array stored contiguously with no padding.
+// Version 1 files have no sound fields in the header and no sound arrays; they still load.
+constexpr char kSceneMagic[4] = {'L', 'A', 'Y', 'B'};
+constexpr uint32_t kSceneVersion = 2;
+
+struct SceneHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t layoutCount;
+    uint32_t primitiveCount;
+    uint32_t colorCount;
+    uint32_t soundCount;      // Version 2 and later
+    uint32_t soundNameBytes;  // Version 2 and later
+};
+constexpr size_t kSceneHeaderSizeV1 = 5 * sizeof(uint32_t);
+
+// True if the bytes start with the binary scene magic
+bool isBinaryScene(std::string_view bytes);
+
+// Serialize a scene to a binary file; returns false on I/O failure
+bool writeBinaryScene(const SceneData& scene, const std::string& fileName);
+
+// Deserialize a binary scene; returns false if the header or sizes are invalid
+bool readBinaryScene(std::string_view bytes, SceneData& scene);
+
+// Append a scene as the last nested layout of parent: its layouts, primitives, colors and
+// sounds are re-indexed, and its root layout gets parent as its parent
+void appendSubScene(SceneData& scene, const SceneData& subScene, uint32_t parent);
+
+// Add the element a scene primitive describes to a layout
+void addSceneElement(Layout& layout, const SceneData& scene, const ScenePrimitive& primitive);
+
+// Where buildLayoutTree allocates the tree
+enum class TreeMemory {
+    Heap,  // Each layout and element array on its own
+    Arena  // One monotonic arena owned by the root, sized from the scene and freed in one go
+};
+
+// Build the Layout/Element tree described by a scene; returns nullptr if it has no root
+std::unique_ptr<Layout> buildLayoutTree(const SceneData& scene, TreeMemory memory = TreeMemory::Heap);
+
+#endif // __SCENE_HPP__
@@ -0,0 +1,99 @@
+#include "../all_headers.hpp"
+
+SceneLoader::SceneLoader(const std::string& fileName, ThreadPool& pool, LoadMode mode) {
+    parsed = pool.submit([this, fileName, mode] { return parse(fileName, mode); });
+}
+
+// The worker fills parts, so it must be done before they go away
+SceneLoader::~SceneLoader() {
+    if (parsed.valid()) {
+        parsed.wait();
+    }
+}
+
+// Root element primitives in [next, end) of the scene, as an unpositioned layout
+static std::unique_ptr<Layout> takeRootElements(const SceneData& scene, size_t& nextPrimitive, size_t& nextSound) {
+    auto part = std::make_unique<Layout>(0, 0, 1, 1, true);
+    for (; nextPrimitive < scene.primitives.size(); ++nextPrimitive) {
+        if (scene.primitives[nextPrimitive].layout == 0) {
+            addSceneElement(*part, scene, scene.primitives[nextPrimitive]);
+        }
+    }
+    for (; nextSound < scene.sounds.size(); ++nextSound) {
+        if (scene.sounds[nextSound].layout == 0) {
+            part->setSound(scene.soundName(scene.sounds[nextSound]));
+        }
+    }
+    return part;
+}
+
+// Worker thread. Each part is a root-like layout holding the new root elements and at most
+// one nested layout; attachReady merges it into the live root.
+bool SceneLoader::parse(const std::string& fileName, LoadMode mode) {
+    PROFILE_SCOPE("SceneLoader::parse");
+    Parser parser(fileName, mode);
+    SceneData scene;
+    size_t nextPrimitive = 0, nextSound = 0;
+    bool streamed = false;
+    bool ok = parser.parseScene(scene, [&](const SceneData& parsedSoFar, const SceneData& layout) {
+        auto part = takeRootElements(parsedSoFar, nextPrimitive, nextSound);
+        part->addNestedLayout(buildLayoutTree(layout));
+        publish(std::move(part));
+        // The subtree is appended to the scene next; it is already built, so skip it
+        nextPrimitive += layout.primitives.size();
+        nextSound += layout.sounds.size();
+        streamed = true;
+    });
+    if (!ok) {
+        std::cerr << "Error: " << fileName << " could not be parsed." << std::endl;
+        return false;
+    }
+
+    if (streamed) {
+        auto rest = takeRootElements(scene, nextPrimitive, nextSound);
+        if (!rest->getElements().empty() || rest->getSoundId() != SoundId::None) {
+            publish(std::move(rest));
+        }
+    } else {
+        publish(buildLayoutTree(scene));
+    }
+    return true;
+}
+
+void SceneLoader::publish(std::unique_ptr<Layout> part) {
+    std::lock_guard<std::mutex> lock(mutex);
+    parts.push_back(std::move(part));
+}
+
+bool SceneLoader::attachReady(Layout& root) {
+    PROFILE_SCOPE("SceneLoader::attachReady");
+    if (finished) {
+        return false;
+    }
+    // Check for the end first: parts published before it are then sure to be taken below
+    bool done = parsed.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+    std::vector<std::unique_ptr<Layout>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(parts);
+    }
+    for (auto& part : ready) {
+        root.adoptContent(std::move(*part));
+    }
+    partsAttached += ready.size();
+
+    if (done) {
+        failed = !parsed.get();
+        finished = true;
+    }
+    return !ready.empty();
+}
+
+bool SceneLoader::finish(Layout& root) {
+    if (parsed.valid()) {
+        parsed.wait();
+    }
+    attachReady(root);
+    return !failed;
+}
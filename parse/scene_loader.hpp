@@ -0,0 +1,52 @@
+#ifndef __SCENE_LOADER_HPP__
+#define __SCENE_LOADER_HPP__
+
+#include "../all_headers.hpp"
+
+// Parses a layout file on a ThreadPool while the UI keeps drawing.
+// The worker builds each layout nested directly in the root as soon as its close tag is
+// parsed, together with the root elements read before it. attachReady(), called by the UI
+// thread between frames, moves those parts into the live root, so the first frame can show
+// the top-level layouts already loaded instead of waiting for the whole file. Binary scenes
+// load in one go and arrive as a single part.
+//
+// Usage:
+//     auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+//     root->calculatePosition({0, 0}, {width, height});
+//     SceneLoader loader("input1.xml", pool);
+//     each frame: loader.attachReady(*root); then render root's dirty regions
+class SceneLoader {
+public:
+    SceneLoader(const std::string& fileName, ThreadPool& pool, LoadMode mode = LoadMode::Buffered);
+    ~SceneLoader();
+
+    SceneLoader(const SceneLoader&) = delete;
+    SceneLoader& operator=(const SceneLoader&) = delete;
+
+    // Move everything parsed since the last call into the root, which must be positioned;
+    // returns true if anything was added
+    bool attachReady(Layout& root);
+
+    // Wait for the parse to end and attach the rest; returns false if the file could not be parsed
+    bool finish(Layout& root);
+
+    // True once the whole file has been parsed and attached (or the parse has failed)
+    bool isFinished() const { return finished; }
+    bool hasFailed() const { return failed; }
+
+    // Parts attached so far: one per top-level layout, plus any root elements after the last one
+    size_t getPartsAttached() const { return partsAttached; }
+
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Layout>> parts;  // Parsed but not yet attached; guarded by mutex
+    std::future<bool> parsed;
+    bool finished = false;
+    bool failed = false;
+    size_t partsAttached = 0;
+
+    bool parse(const std::string& fileName, LoadMode mode);
+    void publish(std::unique_ptr<Layout> part);
+};
+
+#endif // __SCENE_LOADER_HPP__
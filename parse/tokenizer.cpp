@@ -0,0 +1,94 @@
+#include "../all_headers.hpp"
+
+std::string_view trimView(std::string_view text) {
+    size_t first = 0;
+    while (first < text.size() && std::isspace(static_cast<unsigned char>(text[first]))) {
+        ++first;
+    }
+    size_t last = text.size();
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) {
+        --last;
+    }
+    return text.substr(first, last - first);
+}
+
+float parseFloat(std::string_view text, float fallback) {
+    text = trimView(text);
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);  // from_chars rejects a leading '+', std::stof accepted it
+    }
+    float value = fallback;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return (result.ec == std::errc()) ? value : fallback;
+}
+
+// Return the position just past the terminator, or the end of the source if it is missing
+size_t Tokenizer::skipMarkup(size_t from, std::string_view terminator) const {
+    size_t close = source.find(terminator, from);
+    return (close == std::string_view::npos) ? source.size() : close + terminator.size();
+}
+
+Token Tokenizer::next() {
+    if (pendingClose) {
+        pendingClose = false;
+        return {TokenType::CloseTag, pendingName, {}};
+    }
+
+    while (pos < source.size()) {
+        // Character data up to the next tag
+        if (source[pos] != '<') {
+            size_t textEnd = source.find('<', pos);
+            if (textEnd == std::string_view::npos) {
+                textEnd = source.size();
+            }
+            std::string_view text = trimView(source.substr(pos, textEnd - pos));
+            pos = textEnd;
+            if (!text.empty()) {
+                return {TokenType::Text, text, {}};
+            }
+            continue;
+        }
+
+        // Comments, processing instructions and declarations carry no layout data
+        if (source.compare(pos, 4, "<!--") == 0) {
+            pos = skipMarkup(pos + 4, "-->");
+            continue;
+        }
+        if (pos + 1 < source.size() && (source[pos + 1] == '?' || source[pos + 1] == '!')) {
+            pos = skipMarkup(pos + 2, ">");
+            continue;
+        }
+
+        bool closing = (pos + 1 < source.size() && source[pos + 1] == '/');
+        size_t nameStart = pos + (closing ? 2 : 1);
+        size_t tagEnd = source.find('>', nameStart);
+        if (tagEnd == std::string_view::npos) {
+            pos = source.size();
+            break;
+        }
+
+        size_t nameEnd = nameStart;
+        while (nameEnd < tagEnd && source[nameEnd] != '/' &&
+               !std::isspace(static_cast<unsigned char>(source[nameEnd]))) {
+            ++nameEnd;
+        }
+        std::string_view name = source.substr(nameStart, nameEnd - nameStart);
+        bool selfClosing = !closing && source[tagEnd - 1] == '/';
+        size_t attributesEnd = selfClosing ? tagEnd - 1 : tagEnd;
+        pos = tagEnd + 1;
+
+        if (closing) {
+            return {TokenType::CloseTag, name, {}};
+        }
+        if (selfClosing) {
+            pendingClose = true;
+            pendingName = name;
+        }
+        std::string_view attributes = (attributesEnd > nameEnd)
+            ? trimView(source.substr(nameEnd, attributesEnd - nameEnd))
+            : std::string_view();
+        return {TokenType::OpenTag, name, attributes};
+    }
+
+    return {};
+}
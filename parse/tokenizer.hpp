@@ -0,0 +1,41 @@
+#ifndef __TOKENIZER_HPP__
+#define __TOKENIZER_HPP__
+
+#include "../all_headers.hpp"
+
+// Kinds of tokens produced while scanning an XML buffer
+enum class TokenType { OpenTag, CloseTag, Text, End };
+
+struct Token {
+    TokenType type = TokenType::End;
+    std::string_view value;       // Tag name for OpenTag/CloseTag, trimmed content for Text
+    std::string_view attributes;  // Raw attribute text of an OpenTag (e.g. active="true")
+};
+
+// Single-pass, SAX-style tokenizer over an XML buffer.
+// Tokens are views into the source buffer, so no heap allocation happens per token;
+// the buffer must outlive the tokenizer. Comments, processing instructions and
+// whitespace-only text are skipped, and self-closing tags yield an OpenTag/CloseTag pair.
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view source) : source(source), pos(0), pendingClose(false) {}
+
+    Token next();
+    size_t position() const { return pos; }
+
+private:
+    std::string_view source;
+    size_t pos;
+    bool pendingClose;            // Set after a self-closing tag so its CloseTag is returned next
+    std::string_view pendingName;
+
+    size_t skipMarkup(size_t from, std::string_view terminator) const;
+};
+
+// Trim leading and trailing whitespace from a view
+std::string_view trimView(std::string_view text);
+
+// Parse a float from a view without allocating; returns fallback on malformed input
+float parseFloat(std::string_view text, float fallback = 0.0f);
+
+#endif // __TOKENIZER_HPP__
@@ -0,0 +1,82 @@
+#ifndef __PPM_HPP__
+#define __PPM_HPP__
+
+#include "../all_headers.hpp"
+
+// Binary PPM (P6) images: 8-bit RGB, used for golden-image regression checks.
+// Screen pixels are read with the 0x00RRGGBB layout of headless screens.
+struct Image {
+    int width = 0, height = 0;
+    std::vector<uint8_t> rgb;  // width * height * 3 bytes, row-major
+
+    static Image fromScreen(const Screen& screen) {
+        Image image;
+        image.width = static_cast<int>(screen.width);
+        image.height = static_cast<int>(screen.height);
+        image.rgb.resize(static_cast<size_t>(image.width) * image.height * 3);
+        uint8_t* out = image.rgb.data();
+        for (int y = 0; y < image.height; ++y) {
+            const Uint32* row = screen.rowPixels(y);
+            for (int x = 0; x < image.width; ++x) {
+                *out++ = static_cast<uint8_t>(row[x] >> 16);
+                *out++ = static_cast<uint8_t>(row[x] >> 8);
+                *out++ = static_cast<uint8_t>(row[x]);
+            }
+        }
+        return image;
+    }
+
+    bool operator==(const Image& other) const {
+        return width == other.width && height == other.height && rgb == other.rgb;
+    }
+
+    // Number of pixels that differ from other (all of them if the sizes differ)
+    long long countDifferences(const Image& other) const {
+        if (width != other.width || height != other.height) {
+            return static_cast<long long>(std::max(width * height, other.width * other.height));
+        }
+        long long differences = 0;
+        for (size_t i = 0; i < rgb.size(); i += 3) {
+            differences += rgb[i] != other.rgb[i] || rgb[i + 1] != other.rgb[i + 1] || rgb[i + 2] != other.rgb[i + 2];
+        }
+        return differences;
+    }
+};
+
+inline bool writePPM(const std::string& fileName, const Image& image) {
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Could not write image " << fileName << "\n";
+        return false;
+    }
+    file << "P6\n" << image.width << " " << image.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(image.rgb.data()), static_cast<std::streamsize>(image.rgb.size()));
+    return static_cast<bool>(file);
+}
+
+inline bool readPPM(const std::string& fileName, Image& image) {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Could not open image " << fileName << "\n";
+        return false;
+    }
+
+    std::string magic;
+    int maxValue = 0;
+    file >> magic >> image.width >> image.height >> maxValue;
+    file.get();  // Single whitespace byte before the pixel data
+    if (!file || magic != "P6" || maxValue != 255 || image.width <= 0 || image.height <= 0) {
+        std::cerr << "Error: " << fileName << " is not an 8-bit binary PPM image\n";
+        return false;
+    }
+
+    image.rgb.resize(static_cast<size_t>(image.width) * image.height * 3);
+    file.read(reinterpret_cast<char*>(image.rgb.data()), static_cast<std::streamsize>(image.rgb.size()));
+    if (!file) {
+        std::cerr << "Error: " << fileName << " is truncated\n";
+        return false;
+    }
+    return true;
+}
+
+#endif // __PPM_HPP__
@@ -0,0 +1,43 @@
+#ifndef __RECT_HPP__
+#define __RECT_HPP__
+
+#include <algorithm>
+
+// Axis-aligned integer rectangle with inclusive bounds, used for clipping and dirty regions
+struct Rect {
+    int minX = 0, minY = 0, maxX = -1, maxY = -1;  // Default-constructed rectangles are empty
+
+    Rect() = default;
+    Rect(int x0, int y0, int x1, int y1) : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+    bool empty() const { return maxX < minX || maxY < minY; }
+
+    long long area() const {
+        return empty() ? 0 : static_cast<long long>(maxX - minX + 1) * (maxY - minY + 1);
+    }
+
+    bool contains(int x, int y) const {
+        return x >= minX && x <= maxX && y >= minY && y <= maxY;
+    }
+
+    bool intersects(const Rect& other) const {
+        return !empty() && !other.empty() &&
+               minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+
+    // Overlapping part of two rectangles (empty if they do not overlap)
+    Rect intersection(const Rect& other) const {
+        return Rect(std::max(minX, other.minX), std::max(minY, other.minY),
+                    std::min(maxX, other.maxX), std::min(maxY, other.maxY));
+    }
+
+    // Smallest rectangle covering both; an empty operand is ignored
+    Rect merged(const Rect& other) const {
+        if (empty()) return other;
+        if (other.empty()) return *this;
+        return Rect(std::min(minX, other.minX), std::min(minY, other.minY),
+                    std::max(maxX, other.maxX), std::max(maxY, other.maxY));
+    }
+};
+
+#endif // __RECT_HPP__
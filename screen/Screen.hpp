@@ -10,38 +10,132 @@ public:
 
     // Constructor to initialize screen dimensions and surface
     Screen(unsigned int w, unsigned int h, SDL_Surface* targetSurface)
-        : width(w), height(h), surface(targetSurface) {}
+        : width(w), height(h), surface(targetSurface), ownsSurface(true),
+          pixels(static_cast<Uint8*>(targetSurface->pixels)), pitch(targetSurface->pitch), clip(bounds()) {}
+
+    // Headless screen drawing into an owned in-memory buffer, with no SDL surface or video
+    // subsystem. Pixels are 32-bit 0x00RRGGBB, the same values an SDL surface created with
+    // masks 0x00FF0000/0x0000FF00/0x000000FF holds. surface is null and blitTo is unavailable.
+    Screen(unsigned int w, unsigned int h)
+        : width(w), height(h), surface(nullptr), ownsSurface(false), buffer(static_cast<size_t>(w) * h, 0),
+          pixels(reinterpret_cast<Uint8*>(buffer.data())), pitch(static_cast<int>(w * sizeof(Uint32))), clip(bounds()) {}
+
+    // View onto another screen's pixels with its own clip rectangle (intersected with the
+    // target's). Views do not own the surface, so several can draw into disjoint areas of
+    // one screen from different threads.
+    Screen(const Screen& target, const Rect& clipArea)
+        : width(target.width), height(target.height), surface(target.surface), ownsSurface(false),
+          pixels(target.pixels), pitch(target.pitch), clip(clipArea.intersection(target.clip)) {}
+
+    Screen(const Screen&) = delete;
+    Screen& operator=(const Screen&) = delete;
 
     // Destructor to free the surface
     ~Screen() {
-        SDL_FreeSurface(surface);
+        if (ownsSurface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    // Whole-screen rectangle
+    Rect bounds() const {
+        return Rect(0, 0, static_cast<int>(width) - 1, static_cast<int>(height) - 1);
+    }
+
+    // Restrict all drawing to a rectangle (clamped to the screen) until resetClip is called
+    void setClip(const Rect& rect) { clip = rect.intersection(bounds()); }
+    void resetClip() { clip = bounds(); }
+    const Rect& clipRect() const { return clip; }
+
+    // Map an RGB color to the surface's pixel format; do this once per primitive, not per pixel
+    Uint32 mapColor(ivec3 color) const {
+        if (!surface) {
+            return (static_cast<Uint32>(static_cast<Uint8>(color.x)) << 16) |
+                   (static_cast<Uint32>(static_cast<Uint8>(color.y)) << 8) | static_cast<Uint8>(color.z);
+        }
+        return SDL_MapRGB(surface->format, color.x, color.y, color.z);
     }
 
+    // Pixel row y (rows are pitch bytes apart), for reading back what was drawn
+    const Uint32* rowPixels(int y) const { return row(y); }
+
     // Function to set a pixel at a specific position with a given color, with safe boundary checks
     void setSafePixel(ivec2 position, ivec3 color) {
+        setSafePixel(position, mapColor(color));
+    }
+
+    // Same as above with an already mapped color
+    void setSafePixel(ivec2 position, Uint32 pixelColor) {
         int x = position.x;
         int y = position.y;
 
-        // Check for valid position inside the screen bounds
-        if (x < 0 || x >= width || y < 0 || y >= height) {
+        // Check for valid position inside the screen bounds and the clip rectangle
+        if (!clip.contains(x, y)) {
             return;
         }
 
-        // Get pointer to pixel array and map RGB color to Uint32 format
-        Uint32* pixels = (Uint32*)surface->pixels;
-        Uint32 pixelColor = SDL_MapRGB(surface->format, color.x, color.y, color.z);
-
         // Set the pixel at (x, y) to the specified color
-        pixels[(y * surface->w) + x] = pixelColor;
+        row(y)[x] = pixelColor;
+        PROFILE_PIXELS(1);
+    }
+
+    // Fill the horizontal run [x0, x1] on row y with a mapped color.
+    // The run is clipped once against the clip rectangle, then written with the widest
+    // SIMD store kernel the CPU supports (see SpanFill.hpp).
+    void fillSpan(int y, int x0, int x1, Uint32 pixelColor) {
+        if (y < clip.minY || y > clip.maxY) {
+            return;
+        }
+        x0 = std::max(x0, clip.minX);
+        x1 = std::min(x1, clip.maxX);
+        if (x0 > x1) {
+            return;
+        }
+        SpanFill::fill(row(y) + x0, static_cast<size_t>(x1 - x0 + 1), pixelColor);
+        PROFILE_PIXELS(x1 - x0 + 1);
     }
 
     // Function to copy the surface content to the destination surface
     void blitTo(SDL_Surface* destSurface) {
+        if (!surface) return;  // Headless screens have no surface to blit from
         SDL_BlitSurface(surface, NULL, destSurface, NULL);
     }
 
+    // Copy only the given rectangles to the destination surface; returns them as SDL_Rects
+    // so the caller can pass them on to SDL_UpdateWindowSurfaceRects
+    std::vector<SDL_Rect> blitTo(SDL_Surface* destSurface, const std::vector<Rect>& rects) {
+        std::vector<SDL_Rect> sdlRects;
+        if (!surface) return sdlRects;
+        sdlRects.reserve(rects.size());
+        for (const Rect& rect : rects) {
+            Rect visible = rect.intersection(bounds());
+            if (visible.empty()) continue;
+            SDL_Rect area{visible.minX, visible.minY, visible.maxX - visible.minX + 1, visible.maxY - visible.minY + 1};
+            SDL_Rect destArea = area;
+            SDL_BlitSurface(surface, &area, destSurface, &destArea);
+            sdlRects.push_back(area);
+        }
+        return sdlRects;
+    }
+
+    // Fill a rectangle (clipped to the clip rectangle) with a solid color
+    void fillRect(const Rect& rect, ivec3 color) {
+        Rect visible = rect.intersection(clip);
+        if (visible.empty()) return;
+        if (!surface) {
+            Uint32 pixelColor = mapColor(color);
+            for (int y = visible.minY; y <= visible.maxY; ++y) {
+                fillSpan(y, visible.minX, visible.maxX, pixelColor);
+            }
+            return;
+        }
+        SDL_Rect area{visible.minX, visible.minY, visible.maxX - visible.minX + 1, visible.maxY - visible.minY + 1};
+        SDL_FillRect(surface, &area, SDL_MapRGB(surface->format, color.x, color.y, color.z));
+    }
+
     // Bresenham's Line Algorithm to draw a line between two points with safe boundary checks
     void drawSafeLine(ivec2 start, ivec2 end, ivec3 color) {
+        PROFILE_SCOPE("Screen::drawSafeLine");
         // Check if both start and end points are outside the screen bounds
         if ((start.x < 0 || start.x >= width || start.y < 0 || start.y >= height) &&
             (end.x < 0 || end.x >= width || end.y < 0 || end.y >= height)) {
@@ -53,10 +147,11 @@ public:
         int sx = (start.x < end.x) ? 1 : -1;
         int sy = (start.y < end.y) ? 1 : -1;
         int err = dx - dy;
+        Uint32 pixelColor = mapColor(color);
 
         // Loop until the end point is reached
         while (true) {
-            setSafePixel(start, color);  // Draw the current pixel using the safe function
+            setSafePixel(start, pixelColor);  // Draw the current pixel using the safe function
             if (start.x == end.x && start.y == end.y) break;  // Stop when the line is complete
             int e2 = 2 * err;
             if (e2 > -dy) { err -= dy; start.x += sx; }
@@ -66,6 +161,7 @@ public:
 
     // Function to draw a box using safe boundary checks
     void drawSafeBox(ivec2 min, ivec2 max, ivec3 color) {
+        PROFILE_SCOPE("Screen::drawSafeBox");
         // Check if the box coordinates are outside the screen's valid boundaries
         if (min.x < 0 || max.x >= width || min.y < 0 || max.y >= height) {
             std::cerr << "Error: Box coordinates are out of bounds. Skipping box drawing.\n";
@@ -85,47 +181,148 @@ public:
         int minY = std::min(min.y, max.y);
         int maxY = std::max(min.y, max.y);
 
-        // Loop through all pixels in the specified box and set their color
-        for (int x = minX; x <= maxX; ++x) {
-            for (int y = minY; y <= maxY; ++y) {
-                setSafePixel(ivec2(x, y), color);  // Color each pixel in the box using the safe pixel function
-            }
+        // Only visit rows inside the clip rectangle; fillSpan clips each row horizontally
+        minY = std::max(minY, clip.minY);
+        maxY = std::min(maxY, clip.maxY);
+
+        // Fill the box one row at a time with the color mapped once up front
+        Uint32 pixelColor = mapColor(color);
+        for (int y = minY; y <= maxY; ++y) {
+            fillSpan(y, minX, maxX, pixelColor);
         }
     }
 
-    // Function to draw a filled triangle using safe boundary checks
+    // Function to draw a filled triangle using safe boundary checks.
+    // Edge functions are stepped incrementally over the clipped bounding box in 8x8 tiles:
+    // tiles entirely outside an edge are skipped, tiles entirely inside all edges are filled
+    // as whole spans, and only tiles crossing an edge are tested per pixel. Pixel centers that
+    // lie exactly on an edge follow the top-left rule, so triangles sharing an edge neither
+    // overlap nor leave gaps.
     void drawSafeTriangle(ivec2 v0, ivec2 v1, ivec2 v2, ivec3 color) {
+        PROFILE_SCOPE("Screen::drawSafeTriangle");
+        // Orient the vertices so the interior is on the positive side of every edge
+        long long area = edgeFunction(v0, v1, v2);
+        if (area == 0) {
+            return;  // Degenerate triangles cover no area
+        }
+        if (area < 0) {
+            std::swap(v1, v2);
+        }
+
         // Compute the bounding box of the triangle
         int minX = std::min({v0.x, v1.x, v2.x});
         int maxX = std::max({v0.x, v1.x, v2.x});
         int minY = std::min({v0.y, v1.y, v2.y});
         int maxY = std::max({v0.y, v1.y, v2.y});
 
-        // Loop through all pixels within the bounding box
-        for (int y = minY; y <= maxY; ++y) {
-            for (int x = minX; x <= maxX; ++x) {
-                // Use barycentric coordinates or cross-product method to check if the pixel is inside the triangle
-                if (isInsideTriangle(ivec2(x, y), v0, v1, v2)) {
-                    // Set the pixel using safe pixel function
-                    setSafePixel(ivec2(x, y), color);
+        // Only visit pixels inside the clip rectangle
+        minX = std::max(minX, clip.minX);
+        maxX = std::min(maxX, clip.maxX);
+        minY = std::max(minY, clip.minY);
+        maxY = std::min(maxY, clip.maxY);
+
+        const Edge edges[3] = {Edge(v0, v1), Edge(v1, v2), Edge(v2, v0)};
+        Uint32 pixelColor = mapColor(color);
+
+        for (int tileY = minY; tileY <= maxY; tileY += kTileSize) {
+            int tileMaxY = std::min(tileY + kTileSize - 1, maxY);
+            for (int tileX = minX; tileX <= maxX; tileX += kTileSize) {
+                int tileMaxX = std::min(tileX + kTileSize - 1, maxX);
+
+                // Edge functions are linear, so their extremes over a tile are at its corners
+                bool rejected = false;
+                bool accepted = true;
+                for (const Edge& edge : edges) {
+                    long long best = edge.at(edge.stepX > 0 ? tileMaxX : tileX, edge.stepY > 0 ? tileMaxY : tileY);
+                    long long worst = edge.at(edge.stepX > 0 ? tileX : tileMaxX, edge.stepY > 0 ? tileY : tileMaxY);
+                    if (best < 0) {
+                        rejected = true;
+                        break;
+                    }
+                    if (worst < 0) {
+                        accepted = false;
+                    }
+                }
+                if (rejected) {
+                    continue;
+                }
+                if (accepted) {
+                    for (int y = tileY; y <= tileMaxY; ++y) {
+                        fillSpan(y, tileX, tileMaxX, pixelColor);
+                    }
+                    continue;
+                }
+
+                // Partially covered tile: step the edge functions pixel by pixel.
+                // The triangle is convex, so the covered pixels of a row form one run.
+                for (int y = tileY; y <= tileMaxY; ++y) {
+                    long long w0 = edges[0].at(tileX, y);
+                    long long w1 = edges[1].at(tileX, y);
+                    long long w2 = edges[2].at(tileX, y);
+                    int runStart = -1;
+                    int runEnd = -1;
+                    for (int x = tileX; x <= tileMaxX; ++x) {
+                        if ((w0 | w1 | w2) >= 0) {  // All three non-negative
+                            if (runStart < 0) runStart = x;
+                            runEnd = x;
+                        } else if (runStart >= 0) {
+                            break;
+                        }
+                        w0 += edges[0].stepX;
+                        w1 += edges[1].stepX;
+                        w2 += edges[2].stepX;
+                    }
+                    if (runStart >= 0) {
+                        fillSpan(y, runStart, runEnd, pixelColor);
+                    }
                 }
             }
         }
     }
 
 private:
-    // Helper function to check if a point is inside the triangle using the cross product method
-    bool isInsideTriangle(ivec2 p, ivec2 v0, ivec2 v1, ivec2 v2) {
-        // Cross product to find if point p is on the left side of each edge
-        int d1 = (p.x - v0.x) * (v1.y - v0.y) - (p.y - v0.y) * (v1.x - v0.x);
-        int d2 = (p.x - v1.x) * (v2.y - v1.y) - (p.y - v1.y) * (v2.x - v1.x);
-        int d3 = (p.x - v2.x) * (v0.y - v2.y) - (p.y - v2.y) * (v0.x - v2.x);
-
-        // Check if point p is inside the triangle by verifying all cross products have the same sign
-        bool hasNeg = (d1 < 0) || (d2 < 0) || (d3 < 0);
-        bool hasPos = (d1 > 0) || (d2 > 0) || (d3 > 0);
-        return !(hasNeg && hasPos);
+    bool ownsSurface;            // False for views created from another Screen and for headless screens
+    std::vector<Uint32> buffer;  // Pixel storage of a headless screen
+    Uint8* pixels;               // First pixel row, in the surface or the buffer
+    int pitch;                   // Bytes between rows
+    Rect clip;                   // Drawing is restricted to this rectangle; the whole screen by default
+
+    // Start of row y in the pixel array (rows are pitch bytes apart)
+    Uint32* row(int y) const {
+        return reinterpret_cast<Uint32*>(pixels + y * pitch);
     }
+
+    static constexpr int kTileSize = 8;  // Triangle rasterization tile edge, in pixels
+
+    // Twice the signed area of (a, b, p); positive when p is on the interior side of a->b
+    static long long edgeFunction(ivec2 a, ivec2 b, ivec2 p) {
+        return static_cast<long long>(b.x - a.x) * (p.y - a.y) - static_cast<long long>(b.y - a.y) * (p.x - a.x);
+    }
+
+    // Edge function a->b in incremental form: value(x, y) = origin + stepX * x + stepY * y.
+    // The top-left bias is folded into origin, so a pixel is covered when value >= 0.
+    struct Edge {
+        long long stepX, stepY, origin;
+
+        Edge(ivec2 a, ivec2 b) {
+            long long dx = b.x - a.x;
+            long long dy = b.y - a.y;
+            stepX = -dy;
+            stepY = dx;
+            origin = dy * a.x - dx * a.y;
+
+            // With y pointing down and the interior on the positive side, top edges run
+            // in +x and left edges run in -y. Pixels on any other edge belong to the neighbour.
+            bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+            if (!topLeft) {
+                origin -= 1;
+            }
+        }
+
+        long long at(int x, int y) const {
+            return origin + stepX * x + stepY * y;
+        }
+    };
 };
 
 #endif // __SCREEN_HPP__
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef __SPAN_FILL_HPP__
+#define __SPAN_FILL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPAN_FILL_X86 1
+#endif
+
+// Kernels that write one 32-bit pixel value to a contiguous run of pixels.
+// Screen::fillSpan calls whichever kernel the CPU supports best; the choice is made once,
+// at startup, so builds stay portable (no -mavx2 needed) while still using wide stores.
+namespace SpanFill {
+
+using Kernel = void (*)(uint32_t* dst, size_t count, uint32_t value);
+
+inline void fillScalar(uint32_t* dst, size_t count, uint32_t value) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = value;
+    }
+}
+
+#ifdef SPAN_FILL_X86
+// 16-byte unaligned stores. The tail is finished with one store that overlaps the
+// previous one, which keeps short spans (a few dozen pixels) cheap as well.
+__attribute__((target("sse2")))
+inline void fillSSE2(uint32_t* dst, size_t count, uint32_t value) {
+    if (count < 4) {
+        fillScalar(dst, count, value);
+        return;
+    }
+    __m128i wide = _mm_set1_epi32(static_cast<int>(value));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), wide);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), wide);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), wide);
+    }
+    if (i < count) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + count - 4), wide);
+    }
+}
+
+// 32-byte unaligned stores with the same overlapping-tail trick
+__attribute__((target("avx2")))
+inline void fillAVX2(uint32_t* dst, size_t count, uint32_t value) {
+    if (count < 8) {
+        fillSSE2(dst, count, value);
+        return;
+    }
+    __m256i wide = _mm256_set1_epi32(static_cast<int>(value));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), wide);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), wide);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), wide);
+    }
+    if (i < count) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + count - 8), wide);
+    }
+}
+#endif
+
+// Pick the widest kernel the running CPU supports
+inline Kernel selectKernel() {
+#ifdef SPAN_FILL_X86
+    __builtin_cpu_init();  // Needed because this runs during static initialization
+    if (__builtin_cpu_supports("avx2")) return fillAVX2;
+    if (__builtin_cpu_supports("sse2")) return fillSSE2;
+#endif
+    return fillScalar;
+}
+
+inline const Kernel fill = selectKernel();
+
+// Name of the selected kernel, for benchmark output
+inline const char* kernelName() {
+#ifdef SPAN_FILL_X86
+    if (fill == fillAVX2) return "avx2";
+    if (fill == fillSSE2) return "sse2";
+#endif
+    return "scalar";
+}
+
+} // namespace SpanFill
+
+#endif // __SPAN_FILL_HPP__
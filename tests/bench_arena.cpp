@@ -0,0 +1,146 @@
+#include "../all_headers.hpp"
+#include <chrono>
+#include <new>
+
+// Layout tree memory benchmark: builds a dashboard-like scene of many small nested layouts
+// (panels holding widgets, each with a few elements) with buildLayoutTree, once on the heap
+// and once in a monotonic arena (TreeMemory::Arena), and reports the heap allocations and
+// frees, the build time and the teardown time of each. Both trees must draw the same.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+// Heap accounting for the whole program; read around each build and teardown
+static size_t allocationCount = 0;
+static size_t allocatedBytes = 0;
+static size_t freeCount = 0;
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    allocatedBytes += size;
+    if (void* block = std::malloc(size)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    if (block) ++freeCount;
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept { operator delete(block); }
+
+// std::pmr::new_delete_resource allocates through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment) {
+    ++allocationCount;
+    allocatedBytes += size;
+    size_t align = static_cast<size_t>(alignment);
+    if (void* block = std::aligned_alloc(align, (size + align - 1) / align * align)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block, std::align_val_t) noexcept { operator delete(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { operator delete(block); }
+
+static unsigned int seed = 2024;
+static float next(int range) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<float>((seed >> 8) % static_cast<unsigned int>(range));
+}
+
+// panels x panels grid of layouts, each holding a widgets x widgets grid of nested layouts
+// with a box, a line and a point. The defaults keep every widget at least 10x6 pixels.
+static SceneData makeScene(int panels, int widgets) {
+    seed = 2024;
+    SceneData scene;
+    scene.layouts.push_back({0, 0, 1, 1, kSceneNoParent, 1});
+    auto addPrimitive = [&](PrimitiveType type, uint32_t layout, std::initializer_list<float> coords) {
+        ScenePrimitive primitive{type, layout, scene.addColor({next(256), next(256), next(256)}), {}};
+        std::copy(coords.begin(), coords.end(), primitive.coords);
+        scene.primitives.push_back(primitive);
+    };
+
+    float panelSize = 1.0f / panels, widgetSize = 1.0f / widgets;
+    for (int py = 0; py < panels; ++py) {
+        for (int px = 0; px < panels; ++px) {
+            uint32_t panel = static_cast<uint32_t>(scene.layouts.size());
+            scene.layouts.push_back({px * panelSize, py * panelSize, (px + 1) * panelSize, (py + 1) * panelSize, 0, 1});
+            for (int wy = 0; wy < widgets; ++wy) {
+                for (int wx = 0; wx < widgets; ++wx) {
+                    uint32_t widget = static_cast<uint32_t>(scene.layouts.size());
+                    scene.layouts.push_back(
+                        {wx * widgetSize, wy * widgetSize, (wx + 1) * widgetSize, (wy + 1) * widgetSize, panel, 1});
+                    float x = next(3);
+                    addPrimitive(PrimitiveType::Box, widget, {x, 0, x + 5, 3});
+                    addPrimitive(PrimitiveType::Line, widget, {0, 0, next(9), next(5)});
+                    addPrimitive(PrimitiveType::Point, widget, {next(9), next(5)});
+                }
+            }
+        }
+    }
+    return scene;
+}
+
+struct TreeCost {
+    size_t buildAllocations = 0, buildBytes = 0, teardownFrees = 0;
+    double buildMs = 0, teardownMs = 0;
+};
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Build and destroy the tree runs times; the first tree is rendered into screen
+static TreeCost measure(const SceneData& scene, TreeMemory memory, int runs, Screen& screen) {
+    TreeCost cost;
+    for (int run = 0; run < runs; ++run) {
+        size_t countBefore = allocationCount, bytesBefore = allocatedBytes;
+        auto start = std::chrono::steady_clock::now();
+        auto root = buildLayoutTree(scene, memory);
+        cost.buildMs += msSince(start);
+        cost.buildAllocations = allocationCount - countBefore;
+        cost.buildBytes = allocatedBytes - bytesBefore;
+
+        root->calculatePosition({0, 0}, {RES_X, RES_Y});
+        if (run == 0) {
+            root->render(screen);
+        }
+
+        size_t freesBefore = freeCount;
+        start = std::chrono::steady_clock::now();
+        root.reset();
+        cost.teardownMs += msSince(start);
+        cost.teardownFrees = freeCount - freesBefore;
+    }
+    cost.buildMs /= runs;
+    cost.teardownMs /= runs;
+    return cost;
+}
+
+static void report(const char* name, const TreeCost& cost) {
+    std::cout << "  " << name << cost.buildAllocations << " allocations, " << cost.buildBytes / 1024 << " KiB, build "
+              << cost.buildMs << " ms; teardown " << cost.teardownFrees << " frees, " << cost.teardownMs << " ms\n";
+}
+
+int main(int argc, char* argv[]) {
+    const int panels = (argc > 1) ? std::atoi(argv[1]) : 24;
+    const int widgets = (argc > 2) ? std::atoi(argv[2]) : 5;
+    const int runs = (argc > 3) ? std::atoi(argv[3]) : 5;
+
+    SceneData scene = makeScene(panels, widgets);
+    std::cout << scene.layouts.size() << " layouts, " << scene.primitives.size() << " elements, " << runs << " runs\n";
+
+    Screen heapScreen(RES_X, RES_Y), arenaScreen(RES_X, RES_Y);
+    heapScreen.fillRect(heapScreen.bounds(), ivec3(0, 0, 0));
+    arenaScreen.fillRect(arenaScreen.bounds(), ivec3(0, 0, 0));
+    TreeCost heap = measure(scene, TreeMemory::Heap, runs, heapScreen);
+    TreeCost arena = measure(scene, TreeMemory::Arena, runs, arenaScreen);
+    report("Heap:  ", heap);
+    report("Arena: ", arena);
+
+    bool identical = true;
+    for (int y = 0; y < RES_Y; ++y) {
+        identical = identical && std::memcmp(heapScreen.rowPixels(y), arenaScreen.rowPixels(y), RES_X * sizeof(Uint32)) == 0;
+    }
+    std::cout << "  render " << (identical ? "identical" : "MISMATCH") << "\n";
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Box-fill microbenchmark: compares the original column-major, per-pixel fill against
+// the row-by-row span fill with each store kernel, on full-screen and small boxes.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+// The original Screen::drawBox: x in the outer loop, bounds check and SDL_MapRGB per pixel
+static void legacyDrawBox(SDL_Surface* surface, ivec2 min, ivec2 max, ivec3 color) {
+    int minX = std::min(min.x, max.x), maxX = std::max(min.x, max.x);
+    int minY = std::min(min.y, max.y), maxY = std::max(min.y, max.y);
+    for (int x = minX; x <= maxX; ++x) {
+        for (int y = minY; y <= maxY; ++y) {
+            if (x < 0 || x >= surface->w || y < 0 || y >= surface->h) continue;
+            Uint32* pixels = (Uint32*)surface->pixels;
+            pixels[(y * surface->w) + x] = SDL_MapRGB(surface->format, color.x, color.y, color.z);
+        }
+    }
+}
+
+// Row-major box fill with an explicit kernel, mirroring Screen::drawBox
+static void kernelDrawBox(SDL_Surface* surface, SpanFill::Kernel kernel, ivec2 min, ivec2 max, ivec3 color) {
+    Uint32 pixelColor = SDL_MapRGB(surface->format, color.x, color.y, color.z);
+    for (int y = min.y; y <= max.y; ++y) {
+        Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        kernel(row + min.x, static_cast<size_t>(max.x - min.x + 1), pixelColor);
+    }
+}
+
+struct Workload {
+    const char* name;
+    std::vector<std::pair<ivec2, ivec2>> boxes;
+    int iterations;
+};
+
+// Time one fill implementation over a workload and print ns per pixel
+template <typename Fill>
+static void run(const char* name, const Workload& workload, Fill fill) {
+    long long pixels = 0;
+    for (const auto& box : workload.boxes) {
+        pixels += static_cast<long long>(box.second.x - box.first.x + 1) * (box.second.y - box.first.y + 1);
+    }
+    pixels *= workload.iterations;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < workload.iterations; ++i) {
+        ivec3 color(i & 255, 128, 64);
+        for (const auto& box : workload.boxes) {
+            fill(box.first, box.second, color);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << name << ": " << ns / pixels << " ns/pixel, " << (pixels * 4.0) / ns << " GB/s\n";
+}
+
+int main() {
+    SDL_Surface* surface = SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    Screen screen(RES_X, RES_Y, surface);
+
+    std::vector<Workload> workloads;
+    workloads.push_back({"full screen 1280x720", {{ivec2(0, 0), ivec2(RES_X - 1, RES_Y - 1)}}, 200});
+
+    // Small boxes at scattered positions, as in typical layouts
+    Workload small{"10000 boxes of 16x16", {}, 50};
+    unsigned int seed = 12345;
+    for (int i = 0; i < 10000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int x = static_cast<int>((seed >> 8) % (RES_X - 16));
+        seed = seed * 1103515245u + 12345u;
+        int y = static_cast<int>((seed >> 8) % (RES_Y - 16));
+        small.boxes.push_back({ivec2(x, y), ivec2(x + 15, y + 15)});
+    }
+    workloads.push_back(small);
+
+    std::cout << "selected kernel: " << SpanFill::kernelName() << "\n";
+    for (const Workload& workload : workloads) {
+        std::cout << workload.name << "\n";
+        run("legacy per-pixel", workload, [&](ivec2 a, ivec2 b, ivec3 c) { legacyDrawBox(surface, a, b, c); });
+        run("scalar spans    ", workload, [&](ivec2 a, ivec2 b, ivec3 c) { kernelDrawBox(surface, SpanFill::fillScalar, a, b, c); });
+#ifdef SPAN_FILL_X86
+        run("sse2 spans      ", workload, [&](ivec2 a, ivec2 b, ivec3 c) { kernelDrawBox(surface, SpanFill::fillSSE2, a, b, c); });
+        if (__builtin_cpu_supports("avx2")) {
+            run("avx2 spans      ", workload, [&](ivec2 a, ivec2 b, ivec3 c) { kernelDrawBox(surface, SpanFill::fillAVX2, a, b, c); });
+        }
+#endif
+        run("Screen::drawBox ", workload, [&](ivec2 a, ivec2 b, ivec3 c) { screen.drawBox(a, b, c); });
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Screen draw-loop benchmark: per-call cost of the Screen primitives for many small shapes,
+// where passing and copying ivec2/ivec3 values is a large part of the work, plus a plain
+// loop over an array of ivec2. Prints the vector sizes alongside the timings.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+template <typename F>
+static double nsPerCall(size_t calls, int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        body();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (calls * repeats);
+}
+
+int main(int argc, char* argv[]) {
+    const int shapeCount = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    const int repeats = (argc > 2) ? std::atoi(argv[2]) : 10;
+
+    unsigned int seed = 2024;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 8) % static_cast<unsigned int>(range));
+    };
+
+    std::vector<ivec2> points;
+    std::vector<ivec3> colors;
+    for (int i = 0; i < shapeCount * 3; ++i) {
+        points.push_back(ivec2(next(RES_X - 16), next(RES_Y - 16)));
+        colors.push_back(ivec3(next(256), next(256), next(256)));
+    }
+
+    Screen screen(RES_X, RES_Y, SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0));
+    const ivec2 small(8, 6);
+
+    std::cout << "sizeof(ivec2) = " << sizeof(ivec2) << ", sizeof(ivec3) = " << sizeof(ivec3) << "\n";
+    std::cout << shapeCount << " shapes at " << RES_X << "x" << RES_Y << ", ns per call:\n";
+
+    std::cout << "  setSafePixel:     " << nsPerCall(points.size(), repeats, [&] {
+        for (size_t i = 0; i < points.size(); ++i) {
+            screen.setSafePixel(points[i], colors[i]);
+        }
+    }) << "\n";
+
+    std::cout << "  drawSafeLine:     " << nsPerCall(shapeCount, repeats, [&] {
+        for (int i = 0; i < shapeCount; ++i) {
+            screen.drawSafeLine(points[i], points[i] + small, colors[i]);
+        }
+    }) << "\n";
+
+    std::cout << "  drawSafeBox:      " << nsPerCall(shapeCount, repeats, [&] {
+        for (int i = 0; i < shapeCount; ++i) {
+            screen.drawSafeBox(points[i], points[i] + small, colors[i]);
+        }
+    }) << "\n";
+
+    std::cout << "  drawSafeTriangle: " << nsPerCall(shapeCount, repeats, [&] {
+        for (int i = 0; i < shapeCount; ++i) {
+            ivec2 v0 = points[i];
+            screen.drawSafeTriangle(v0, v0 + ivec2(12, 2), v0 + ivec2(4, 12), colors[i]);
+        }
+    }) << "\n";
+
+    // Pure vector arithmetic over an array, no drawing
+    ivec2 sum;
+    std::cout << "  ivec2 array sum:  " << nsPerCall(points.size(), repeats * 10, [&] {
+        for (const ivec2& point : points) {
+            sum += point;
+        }
+    }) << " (checksum " << sum.x + sum.y << ")\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "../all_headers.hpp"
+#include <chrono>
+#include <new>
+
+// Element storage benchmark: builds the same 100k small random elements as one heap object per
+// element (std::vector<std::unique_ptr<Element>>, the previous Layout storage) and as a
+// Layout's ElementStore, then compares heap use, the time to walk the elements and record
+// them, and the time to draw a frame from each.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+// Heap accounting for the whole program; reset before each build
+static size_t allocationCount = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    allocatedBytes += size;
+    if (void* block = std::malloc(size)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+
+static unsigned int seed = 2024;
+static float next(int range) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<float>((seed >> 8) % static_cast<unsigned int>(range));
+}
+
+// Same element sequence for both stores: small shapes, so per-element overhead dominates
+static std::vector<std::unique_ptr<Element>> makeElements(int elementCount) {
+    seed = 2024;
+    std::vector<std::unique_ptr<Element>> elements;
+    for (int i = 0; i < elementCount; ++i) {
+        std::array<float, 3> color = {next(256), next(256), next(256)};
+        float x = next(RES_X - 16), y = next(RES_Y - 16);
+        switch (i % 4) {
+            case 0: elements.push_back(ElementFactory::createBox({x, y}, {x + next(16), y + next(16)}, color)); break;
+            case 1: elements.push_back(ElementFactory::createTriangle({x, y}, {x + next(16), y + next(4)}, {x + next(8), y + next(16)}, color)); break;
+            case 2: elements.push_back(ElementFactory::createLine({x, y}, {x + next(16), y + next(16)}, color)); break;
+            default: elements.push_back(ElementFactory::createPoint({x, y}, color)); break;
+        }
+    }
+    return elements;
+}
+
+template <typename F>
+static double timeMs(int frames, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        body();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main(int argc, char* argv[]) {
+    const int elementCount = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    const int frames = (argc > 2) ? std::atoi(argv[2]) : 20;
+    const ivec2 origin(0, 0), limit(RES_X, RES_Y);
+
+    // Previous layout: one allocation per element
+    size_t countBefore = allocationCount, bytesBefore = allocatedBytes;
+    auto pointers = makeElements(elementCount);
+    size_t pointerAllocations = allocationCount - countBefore;
+    size_t pointerBytes = allocatedBytes - bytesBefore;
+
+    // Structure of arrays: elements copied by value into the Layout's store
+    countBefore = allocationCount;
+    bytesBefore = allocatedBytes;
+    Layout root(0, 0, 1, 1, true);
+    root.calculatePosition(origin, limit);
+    for (const auto& element : pointers) {
+        root.addElement(*element);
+    }
+    size_t storeAllocations = allocationCount - countBefore;
+    size_t storeBytes = root.getElements().memoryUse();
+
+    std::cout << elementCount << " elements at " << RES_X << "x" << RES_Y << "\n";
+    // Requested bytes; the per-element allocations also pay the allocator's block overhead
+    std::cout << "  unique_ptr vector: " << pointerAllocations << " allocations, " << pointerBytes / 1024 << " KiB\n";
+    std::cout << "  ElementStore:      " << storeAllocations << " allocations, " << storeBytes / 1024 << " KiB\n";
+
+    // Walking the elements to record commands, which is what a display list rebuild costs
+    DisplayList list;
+    double pointerRecordMs = timeMs(frames, [&] {
+        list.clear();
+        for (const auto& element : pointers) {
+            element->record(list, origin, limit);
+        }
+    });
+    double storeRecordMs = timeMs(frames, [&] {
+        list.clear();
+        root.getElements().record(list, origin, limit);
+    });
+    std::cout << "  record: unique_ptr vector " << pointerRecordMs << " ms, ElementStore " << storeRecordMs << " ms\n";
+
+    // Full frames: virtual draw per element against the store's cached display list
+    Screen previous(RES_X, RES_Y, SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0));
+    Screen current(RES_X, RES_Y, SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0));
+    double pointerDrawMs = timeMs(frames, [&] {
+        for (const auto& element : pointers) {
+            element->draw(previous, origin, limit);
+        }
+    });
+    double storeDrawMs = timeMs(frames, [&] { root.render(current); });
+    bool identical = std::memcmp(previous.surface->pixels, current.surface->pixels, static_cast<size_t>(RES_X) * RES_Y * 4) == 0;
+    std::cout << "  render: unique_ptr vector " << pointerDrawMs << " ms/frame, Layout " << storeDrawMs << " ms/frame"
+              << (identical ? ", identical" : ", MISMATCH") << "\n";
+    return identical ? 0 : 1;
+}
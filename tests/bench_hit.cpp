@@ -0,0 +1,69 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Hit-testing benchmark: a layout with many hoverable buttons receives a stream of SHOW events
+// at random mouse positions. Layout::handleEvent (grid lookup) is timed against a linear scan
+// over every button, and the hover result of each event is checked against the scan.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+int main(int argc, char* argv[]) {
+    const int buttonCount = (argc > 1) ? std::atoi(argv[1]) : 5000;
+    const int eventCount = (argc > 2) ? std::atoi(argv[2]) : 200000;
+
+    unsigned int seed = 2024;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 8) % static_cast<unsigned int>(range));
+    };
+
+    // The nested layout is shown while a button is hovered, which makes the result observable
+    Layout root(0, 0, 1, 1, true);
+    auto nested = std::make_unique<Layout>(0, 0, 1, 1, false);
+    Layout* hoverTarget = nested.get();
+    root.addNestedLayout(std::move(nested));
+
+    std::vector<ButtonElement> buttons;
+    for (int i = 0; i < buttonCount; ++i) {
+        buttons.emplace_back(ivec2(next(RES_X - 20), next(RES_Y - 20)), ivec2(next(20), next(20)), ivec3(255, 255, 255), true, false);
+        root.addElement(buttons.back());
+    }
+    root.calculatePosition({0, 0}, {RES_X, RES_Y});
+
+    std::vector<Event> events;
+    for (int i = 0; i < eventCount; ++i) {
+        events.emplace_back(EventType::SHOW, next(RES_X), next(RES_Y));
+    }
+
+    // Linear scan, as handleEvent did before the grid
+    std::vector<char> expected(events.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); ++i) {
+        bool hovering = false;
+        for (const ButtonElement& button : buttons) {
+            if (button.isHoverable() && button.handleHover(events[i])) {
+                hovering = true;
+                break;
+            }
+        }
+        expected[i] = hovering;
+    }
+    double scanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / events.size();
+
+    size_t mismatches = 0, hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); ++i) {
+        root.handleEvent(events[i], nullptr);
+        bool hovering = hoverTarget->isActive();
+        hits += hovering;
+        mismatches += hovering != static_cast<bool>(expected[i]);
+    }
+    double gridNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / events.size();
+
+    std::cout << buttonCount << " buttons, " << events.size() << " SHOW events (" << hits << " hovering)\n";
+    std::cout << "  linear scan:        " << scanNs << " ns/event\n";
+    std::cout << "  Layout::handleEvent: " << gridNs << " ns/event, speedup " << scanNs / gridNs
+              << (mismatches ? ", MISMATCH" : ", same results") << "\n";
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Matrix benchmark: chains of 3x3 and 4x4 float products with the runtime-sized Matrix<float>
+// (nested std::vector storage, checked access) and with the fixed-size mat3/mat4 (inline
+// storage, SSE kernels). Both chains must produce the same result.
+
+template <typename F>
+static double nsPerMultiply(int count, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+template <int N>
+static bool run(int count) {
+    // A small rotation in the x/y plane (and z/w for 4x4), so repeated products stay bounded
+    const float c = std::cos(0.001f), s = std::sin(0.001f);
+    Matrix<float, N, N> step = Matrix<float, N, N>::identity();
+    for (int plane = 0; plane + 1 < N; plane += 2) {
+        step(plane, plane) = c;
+        step(plane, plane + 1) = -s;
+        step(plane + 1, plane) = s;
+        step(plane + 1, plane + 1) = c;
+    }
+    Matrix<float> dynamicStep(N, N);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            dynamicStep(i, j) = step(i, j);
+        }
+    }
+
+    Matrix<float> dynamicResult(N, N);
+    for (int i = 0; i < N; ++i) dynamicResult(i, i) = 1.0f;
+    double dynamicNs = nsPerMultiply(count, [&] {
+        for (int i = 0; i < count; ++i) {
+            dynamicResult = dynamicResult * dynamicStep;
+        }
+    });
+
+    Matrix<float, N, N> fixedResult = Matrix<float, N, N>::identity();
+    double fixedNs = nsPerMultiply(count, [&] {
+        for (int i = 0; i < count; ++i) {
+            fixedResult = fixedResult * step;
+        }
+    });
+
+    // The kernels accumulate in the same order as the scalar loop, so results match exactly
+    bool same = true;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            same = same && fixedResult(i, j) == dynamicResult(i, j);
+        }
+    }
+    std::cout << "  " << N << "x" << N << ": Matrix<float> " << dynamicNs << " ns, Matrix<float, " << N << ", " << N << "> "
+              << fixedNs << " ns, speedup " << dynamicNs / fixedNs << (same ? ", same result" : ", MISMATCH") << "\n";
+    return same;
+}
+
+int main(int argc, char* argv[]) {
+    const int count = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    std::cout << count << " chained multiplies, per multiply:\n";
+    bool same = run<3>(count);
+    same = run<4>(count) && same;
+    return same ? 0 : 1;
+}
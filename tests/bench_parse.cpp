@@ -0,0 +1,142 @@
+#include "../all_headers.hpp"
+#include <chrono>
+#include <sstream>
+
+// Load-time benchmark: replicate the body of input1.xml N times inside a single root
+// layout and time how long Parser takes to build the Layout tree from it, once for
+// each LoadMode and once from the same scene compiled to the binary format.
+int main(int argc, char* argv[]) {
+    const std::string sourceFile = (argc > 1) ? argv[1] : "input1.xml";
+    const int scale = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    const std::string scaledFile = "bench_parse_scaled.xml";
+    const std::string compiledFile = "bench_parse_scaled.layb";
+
+    std::ifstream source(sourceFile);
+    if (!source) {
+        std::cerr << "Error: could not open " << sourceFile << std::endl;
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << source.rdbuf();
+    std::string xml = buffer.str();
+
+    // Strip the outermost <layout> ... </layout> so the body can be repeated
+    size_t bodyStart = xml.find("<layout>");
+    size_t bodyEnd = xml.rfind("</layout>");
+    if (bodyStart == std::string::npos || bodyEnd == std::string::npos || bodyEnd <= bodyStart) {
+        std::cerr << "Error: " << sourceFile << " has no root layout" << std::endl;
+        return 1;
+    }
+    bodyStart += std::string("<layout>").size();
+    std::string body = xml.substr(bodyStart, bodyEnd - bodyStart);
+
+    {
+        std::ofstream scaled(scaledFile);
+        scaled << "<layout>\n";
+        for (int i = 0; i < scale; ++i) {
+            scaled << body;
+        }
+        scaled << "</layout>\n";
+    }
+    size_t bytes = body.size() * scale;
+
+    double megabytes = bytes / (1024.0 * 1024.0);
+    std::cout << sourceFile << " x" << scale << " (" << megabytes << " MB)\n";
+
+    // Compile the scaled scene once up front for the binary run
+    {
+        Parser parser(scaledFile, LoadMode::Mapped);
+        SceneData scene;
+        if (!parser.parseScene(scene) || !writeBinaryScene(scene, compiledFile)) {
+            std::cerr << "Error: scaled layout could not be compiled." << std::endl;
+            std::remove(scaledFile.c_str());
+            return 1;
+        }
+        std::cout << scene.layouts.size() << " layouts, " << scene.primitives.size() << " primitives\n";
+    }
+
+    struct Run { const std::string& file; LoadMode mode; const char* name; };
+    const Run runs[] = {
+        {scaledFile, LoadMode::Buffered, "xml buffered"},
+        {scaledFile, LoadMode::Mapped, "xml mapped"},
+        {compiledFile, LoadMode::Mapped, "binary mapped"},
+    };
+    bool failed = false;
+    for (const Run& run : runs) {
+        auto loadStart = std::chrono::steady_clock::now();
+        Parser parser(run.file, run.mode);
+        auto parseStart = std::chrono::steady_clock::now();
+        auto rootLayout = parser.parseRootLayout();
+        auto parseEnd = std::chrono::steady_clock::now();
+
+        if (!rootLayout) {
+            std::cerr << "Error: " << run.file << " could not be parsed." << std::endl;
+            failed = true;
+            break;
+        }
+
+        double loadMs = std::chrono::duration<double, std::milli>(parseStart - loadStart).count();
+        double parseMs = std::chrono::duration<double, std::milli>(parseEnd - parseStart).count();
+
+        std::cout << "[" << run.name << "]\n";
+        std::cout << "  load:  " << loadMs << " ms\n";
+        std::cout << "  parse: " << parseMs << " ms (" << megabytes / (parseMs / 1000.0) << " MB/s of XML)\n";
+        std::cout << "  total: " << loadMs + parseMs << " ms\n";
+    }
+
+    // Scene parse alone, serially and with the top-level layouts spread over 1, 2, 4, ... threads
+    if (!failed) {
+        Parser serialParser(scaledFile, LoadMode::Mapped);
+        SceneData serialScene;
+        auto start = std::chrono::steady_clock::now();
+        serialParser.parseScene(serialScene);
+        double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[xml mapped, scene only]\n";
+        std::cout << "  serial:      " << serialMs << " ms\n";
+
+        unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+            ThreadPool pool(threads);
+            Parser parser(scaledFile, LoadMode::Mapped);
+            SceneData scene;
+            start = std::chrono::steady_clock::now();
+            parser.parseSceneParallel(scene, pool);
+            double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            bool identical = scene.layouts.size() == serialScene.layouts.size() &&
+                             scene.primitives.size() == serialScene.primitives.size() &&
+                             std::memcmp(scene.primitives.data(), serialScene.primitives.data(),
+                                         scene.primitives.size() * sizeof(ScenePrimitive)) == 0;
+
+            std::cout << "  parallel x" << threads << ": " << parallelMs << " ms, speedup " << serialMs / parallelMs
+                      << (identical ? ", identical" : ", MISMATCH") << "\n";
+            if (!identical) failed = true;
+            if (threads * 2 > maxThreads && threads != maxThreads) threads = maxThreads / 2;
+        }
+    }
+
+    // Background parse: how long until the first top-level layout can be drawn, and until all are
+    if (!failed) {
+        ThreadPool pool(1);
+        Layout root(0, 0, 1, 1, true);
+        root.calculatePosition({0, 0}, {1280, 720});
+        auto loadStart = std::chrono::steady_clock::now();
+        SceneLoader loader(scaledFile, pool, LoadMode::Mapped);
+        double firstMs = 0;
+        while (!loader.isFinished()) {
+            if (loader.attachReady(root) && firstMs == 0) {
+                firstMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // A UI would wait for its next frame here
+        }
+        double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+        std::cout << "[xml async]\n";
+        std::cout << "  first layout: " << firstMs << " ms\n";
+        std::cout << "  all layouts:  " << totalMs << " ms (" << loader.getPartsAttached() << " parts)\n";
+        failed = loader.hasFailed();
+    }
+
+    std::remove(scaledFile.c_str());
+    std::remove(compiledFile.c_str());
+    return failed ? 1 : 0;
+}
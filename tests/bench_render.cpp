@@ -0,0 +1,68 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Headless render benchmark and golden-image check. Each layout is rendered N times into an
+// in-memory Screen (no window, no SDL video), reporting frames per second and ns per pixel,
+// and the last frame is compared with tests/golden/<name>.ppm.
+// Usage: bench_render [frames] [--update]   (--update rewrites the golden images)
+// Built with make PROFILE=1 it also prints per-frame timings and writes profile.json.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+
+int main(int argc, char* argv[]) {
+    int frames = 100;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--update") {
+            update = true;
+        } else {
+            frames = std::max(1, std::atoi(argv[i]));
+        }
+    }
+
+    bool allMatch = true;
+    for (const std::string name : {"input", "input1"}) {
+        Parser parser(name + ".xml");
+        auto root = parser.parseRootLayout();
+        if (!root) {
+            std::cerr << "Error: Could not load " << name << ".xml\n";
+            return 1;
+        }
+        root->calculatePosition({0, 0}, {RES_X, RES_Y});
+
+        // Full repaints: clear, then draw the whole tree
+        Screen screen(RES_X, RES_Y);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) {
+            screen.fillRect(screen.bounds(), ivec3(0, 0, 0));
+            root->render(screen);
+            PROFILE_FRAME();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double nsPerPixel = seconds * 1e9 / (static_cast<double>(frames) * RES_X * RES_Y);
+
+        std::cout << name << ".xml at " << RES_X << "x" << RES_Y << ": " << frames / seconds << " fps, "
+                  << nsPerPixel << " ns/pixel";
+
+        Image image = Image::fromScreen(screen);
+        std::string goldenFile = "tests/golden/" + name + ".ppm";
+        if (update) {
+            std::cout << (writePPM(goldenFile, image) ? ", golden image updated\n" : "\n");
+            continue;
+        }
+
+        Image golden;
+        if (!readPPM(goldenFile, golden)) {
+            std::cout << ", no golden image\n";
+            allMatch = false;
+            continue;
+        }
+        long long differences = image.countDifferences(golden);
+        std::cout << (differences == 0 ? ", matches golden image\n" : ", differs from golden image in ")
+                  << (differences == 0 ? "" : std::to_string(differences) + " pixels\n");
+        allMatch = allMatch && differences == 0;
+    }
+    PROFILE_WRITE("profile.json");
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include "../all_headers.hpp"
+#include <chrono>
+
+// Tile renderer benchmark: renders a scene of many random elements at 4K, single-threaded
+// with Layout::render and with TileRenderer on pools of increasing size, and checks that
+// every multithreaded frame is pixel-identical to the single-threaded one.
+
+const int RES_X = 3840;
+const int RES_Y = 2160;
+
+static std::unique_ptr<Layout> buildScene(int elementCount) {
+    auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+    unsigned int seed = 2024;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<float>((seed >> 8) % static_cast<unsigned int>(range));
+    };
+
+    for (int i = 0; i < elementCount; ++i) {
+        std::array<float, 3> color = {next(256), next(256), next(256)};
+        float x = next(RES_X - 200), y = next(RES_Y - 200);
+        switch (i % 3) {
+            case 0:
+                root->addElement(*ElementFactory::createBox({x, y}, {x + next(200), y + next(200)}, color));
+                break;
+            case 1:
+                root->addElement(*ElementFactory::createTriangle({x, y}, {x + next(200), y + next(50)}, {x + next(100), y + next(200)}, color));
+                break;
+            default:
+                root->addElement(*ElementFactory::createLine({x, y}, {x + next(200), y + next(200)}, color));
+                break;
+        }
+    }
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    return root;
+}
+
+int main(int argc, char* argv[]) {
+    const int elementCount = (argc > 1) ? std::atoi(argv[1]) : 20000;
+    const int frames = (argc > 2) ? std::atoi(argv[2]) : 10;
+    auto root = buildScene(elementCount);
+    const size_t frameBytes = static_cast<size_t>(RES_X) * RES_Y * 4;
+
+    Screen reference(RES_X, RES_Y, SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        root->render(reference);
+    }
+    double singleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    std::cout << elementCount << " elements at " << RES_X << "x" << RES_Y << "\n";
+    std::cout << "  Layout::render: " << singleMs << " ms/frame\n";
+
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        TileRenderer renderer(pool);
+        Screen screen(RES_X, RES_Y, SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0));
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) {
+            renderer.render(*root, screen);
+        }
+        double tiledMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+        bool identical = std::memcmp(reference.surface->pixels, screen.surface->pixels, frameBytes) == 0;
+
+        std::cout << "  TileRenderer x" << threads << ": " << tiledMs << " ms/frame, speedup "
+                  << singleMs / tiledMs << (identical ? ", identical" : ", MISMATCH") << "\n";
+        if (!identical) return 1;
+        if (threads * 2 > maxThreads && threads != maxThreads) threads = maxThreads / 2;
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef SAME_PIXELS_HPP
+#define SAME_PIXELS_HPP
+
+#include <cstring>
+#include "all_headers.hpp"
+
+// True if two screens have the same size and every pixel matches; compares row by row, so
+// screens with different pitches compare by their visible pixels only
+inline bool samePixels(const Screen& a, const Screen& b) {
+    if (a.width != b.width || a.height != b.height) return false;
+    for (unsigned int y = 0; y < a.height; ++y) {
+        if (std::memcmp(a.rowPixels(static_cast<int>(y)), b.rowPixels(static_cast<int>(y)), a.width * sizeof(Uint32)) != 0)
+            return false;
+    }
+    return true;
+}
+
+#endif // SAME_PIXELS_HPP
@@ -0,0 +1,200 @@
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include "all_headers.hpp"
+#include "same_pixels.hpp"
+#include "EventQueue.hpp"
+
+// EventQueue tests: which events survive coalescing, that a layout driven through the
+// queue once per frame ends each frame in the same state as one handling every event, and
+// that queuing and dispatching events does not allocate.
+
+const int RES_X = 200;
+const int RES_Y = 160;
+
+// Heap allocations made by the whole program
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    if (void* block = std::malloc(size)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    ++allocationCount;
+    size_t align = static_cast<size_t>(alignment);
+    if (void* block = std::aligned_alloc(align, (size + align - 1) / align * align)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { std::free(block); }
+
+// Hovering the left button shows the nested panel; clicking the right one toggles it
+std::unique_ptr<Layout> buildScene() {
+    auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+    auto panel = std::make_unique<Layout>(0.5f, 0.5f, 1, 1, false);
+    panel->addElement(BoxElement({5, 5}, {40, 30}, {255, 0, 0}));
+    root->addNestedLayout(std::move(panel));
+    root->addElement(ButtonElement({10, 10}, {40, 40}, {0, 255, 0}, true, false));
+    root->addElement(ButtonElement({120, 10}, {40, 40}, {0, 0, 255}, false, true));
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    return root;
+}
+
+void test_coalescing() {
+    EventQueue queue;
+    for (int i = 0; i < 10; ++i) queue.push(Event(EventType::SHOW, i, i));
+    queue.push(Event(EventType::CLICK, 100, 100));
+    for (int i = 0; i < 5; ++i) queue.push(Event(EventType::SHOW, 50 + i, 60 + i));
+    queue.push(Event(EventType::CLICK, 1, 2));
+    queue.push(Event(EventType::CLICK, 3, 4));
+
+    // Left queued: SHOW(9, 9), CLICK, SHOW(54, 64), CLICK, CLICK. The empty layout has no
+    // buttons, so no click reaches the (absent) sound player.
+    size_t queued = queue.size();
+    Layout empty(0, 0, 1, 1, true);
+    empty.calculatePosition({0, 0}, {RES_X, RES_Y});
+    queue.dispatch(empty, nullptr);
+
+    if (queued == 5 && queue.empty() && queue.getReceived() == 18 && queue.getDispatched() == 5)
+        std::cout << "Coalescing test PASSED!\n";
+    else
+        std::cout << "Coalescing test FAILED! (" << queued << " queued, " << queue.getDispatched() << " dispatched)\n";
+}
+
+void test_sdl_translation() {
+    EventQueue queue;
+    SDL_Event event;
+    std::memset(&event, 0, sizeof(event));
+    event.type = SDL_MOUSEMOTION;
+    event.motion.x = 7;
+    event.motion.y = 8;
+    bool motion = queue.push(event);
+    event.type = SDL_QUIT;
+    bool quit = queue.push(event);
+
+    if (motion && !quit && queue.size() == 1 && queue.getReceived() == 1)
+        std::cout << "SDL event translation test PASSED!\n";
+    else
+        std::cout << "SDL event translation test FAILED!\n";
+}
+
+// Random mouse flicks with occasional clicks, 40 events per frame
+void test_frame_dispatch_matches_direct(SoundPlayer& soundPlayer) {
+    auto direct = buildScene();
+    auto queued = buildScene();
+    EventQueue queue;
+    Screen directScreen(RES_X, RES_Y), queuedScreen(RES_X, RES_Y);
+
+    unsigned int seed = 7;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 8) % static_cast<unsigned int>(range));
+    };
+
+    bool same = true;
+    for (int frame = 0; frame < 200 && same; ++frame) {
+        for (int i = 0; i < 40; ++i) {
+            Event event(next(20) == 0 ? EventType::CLICK : EventType::SHOW, next(RES_X), next(RES_Y));
+            direct->handleEvent(event, &soundPlayer);
+            queue.push(event);
+        }
+        queue.dispatch(*queued, &soundPlayer);
+
+        directScreen.fillRect(directScreen.bounds(), ivec3(0, 0, 0));
+        queuedScreen.fillRect(queuedScreen.bounds(), ivec3(0, 0, 0));
+        direct->render(directScreen);
+        queued->render(queuedScreen);
+        same = samePixels(directScreen, queuedScreen);
+    }
+
+    if (same && queue.getDispatched() < queue.getReceived())
+        std::cout << "Frame dispatch test PASSED! (" << queue.getReceived() << " events received, "
+                  << queue.getDispatched() << " dispatched)\n";
+    else
+        std::cout << "Frame dispatch test FAILED!\n";
+}
+
+// Mouse motion and clicks pushed as SDL events, including clicks on a nested button whose
+// sound comes from the root. After a warm-up frame has sized the layout's buffers, no
+// push or dispatch may allocate.
+void test_dispatch_does_not_allocate(SoundPlayer& soundPlayer) {
+    auto root = buildScene();
+    root->setSound("test_event_queue.wav");  // Missing: the first click caches the failed load
+    auto toolbar = std::make_unique<Layout>(0, 0.75f, 1, 1, true);
+    toolbar->addElement(ButtonElement({0, 0}, {30, 30}, {255, 255, 0}, false, true));
+    root->addNestedLayout(std::move(toolbar));
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    EventQueue queue;
+    Screen screen(RES_X, RES_Y);
+
+    SDL_Event event;
+    std::memset(&event, 0, sizeof(event));
+    auto motion = [&](int x, int y) {
+        event.type = SDL_MOUSEMOTION;
+        event.motion.x = x;
+        event.motion.y = y;
+        queue.push(event);
+    };
+    auto click = [&](int x, int y) {
+        event.type = SDL_MOUSEBUTTONDOWN;
+        event.button.x = x;
+        event.button.y = y;
+        queue.push(event);
+    };
+
+    // Warm-up: more hover toggles and clicks in one frame than any frame below
+    for (int i = 0; i < 60; ++i) {
+        motion(20, 20);
+        click(130, 20);
+        motion(100, 100);
+        click(5, 125);
+    }
+    queue.dispatch(*root, &soundPlayer);
+    root->renderDirty(screen);
+
+    unsigned int seed = 11;
+    auto next = [&seed](int range) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 8) % static_cast<unsigned int>(range));
+    };
+    size_t allocations = 0;
+    uint64_t dispatchedBefore = queue.getDispatched();
+    for (int frame = 0; frame < 200; ++frame) {
+        size_t before = allocationCount;
+        for (int i = 0; i < 40; ++i) {
+            int x = next(RES_X), y = next(RES_Y);
+            if (next(10) == 0) {
+                click(x, y);
+            } else {
+                motion(x, y);
+            }
+        }
+        queue.dispatch(*root, &soundPlayer);
+        allocations += allocationCount - before;
+        root->renderDirty(screen);  // Not counted: rendering may allocate
+    }
+
+    if (allocations == 0 && queue.getDispatched() - dispatchedBefore > 200 && queue.getDropped() == 0)
+        std::cout << "Dispatch allocation test PASSED! (" << queue.getDispatched() - dispatchedBefore
+                  << " events dispatched, sizeof(Event) = " << sizeof(Event) << ")\n";
+    else
+        std::cout << "Dispatch allocation test FAILED! (" << allocations << " allocations)\n";
+}
+
+int main() {
+    // Clicks play a sound; no clip is loaded, so playSound does nothing
+    setenv("SDL_AUDIODRIVER", "dummy", 0);
+    SoundPlayer soundPlayer;
+
+    std::cout << "Running EventQueue tests...\n";
+    test_coalescing();
+    test_sdl_translation();
+    test_frame_dispatch_matches_direct(soundPlayer);
+    test_dispatch_does_not_allocate(soundPlayer);
+    return 0;
+}
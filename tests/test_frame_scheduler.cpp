@@ -0,0 +1,124 @@
+#include <iostream>
+#include <thread>
+#include "all_headers.hpp"
+#include "FrameScheduler.hpp"
+
+// FrameScheduler tests. They use only SDL's event queue (no window), pushing events with
+// SDL_PushEvent and checking how long waitEvent takes to return. Timings allow for a loaded
+// machine; they fail only when the scheduler sleeps far longer than it should.
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void pushMotion(int x, int y) {
+    SDL_Event event;
+    std::memset(&event, 0, sizeof(event));
+    event.type = SDL_MOUSEMOTION;
+    event.motion.x = x;
+    event.motion.y = y;
+    SDL_PushEvent(&event);
+}
+
+void drainEvents() {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {}
+}
+
+// Input that is already queued comes back without waiting
+void test_pending_input() {
+    drainEvents();
+    FrameScheduler scheduler(60.0, 1000);
+    pushMotion(10, 20);
+
+    SDL_Event event;
+    auto start = Clock::now();
+    bool received = scheduler.waitEvent(event, false);
+    double waited = msSince(start);
+
+    if (received && event.type == SDL_MOUSEMOTION && event.motion.x == 10 && waited < 50.0)
+        std::cout << "Pending input test PASSED!\n";
+    else
+        std::cout << "Pending input test FAILED! (waited " << waited << " ms)\n";
+}
+
+// Waiting for the next frame is cut short by input from another thread
+void test_input_wakes_wait() {
+    drainEvents();
+    FrameScheduler scheduler(2.0, 1000);  // 500 ms frames
+    scheduler.beginRender();
+    scheduler.endRender();
+
+    std::thread sender([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        pushMotion(1, 2);
+    });
+    SDL_Event event;
+    auto start = Clock::now();
+    bool received = scheduler.waitEvent(event, true);
+    double waited = msSince(start);
+    sender.join();
+
+    if (received && waited < 250.0)
+        std::cout << "Input wakes wait test PASSED!\n";
+    else
+        std::cout << "Input wakes wait test FAILED! (waited " << waited << " ms)\n";
+}
+
+// With nothing dirty there is no frame to draw: waitEvent sleeps up to the idle timeout
+void test_idle_skips_frames() {
+    drainEvents();
+    FrameScheduler scheduler(1000.0, 30);
+    SDL_Event event;
+    auto start = Clock::now();
+    bool received = scheduler.waitEvent(event, false);
+    double waited = msSince(start);
+
+    if (!received && waited >= 25.0 && scheduler.getIdleWakeups() == 1 && scheduler.getFramesRendered() == 0)
+        std::cout << "Idle frame skip test PASSED!\n";
+    else
+        std::cout << "Idle frame skip test FAILED! (waited " << waited << " ms)\n";
+}
+
+// Render cost comes out of the frame budget: 20 frames of 5 ms work at 50 FPS take about
+// 20 * 20 ms, where sleeping a fixed interval after each frame would take 20 * 25 ms
+void test_render_cost_in_budget() {
+    drainEvents();
+    const int frames = 20;
+    FrameScheduler scheduler(50.0, 1000);
+    auto start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        SDL_Event event;
+        while (scheduler.waitEvent(event, true)) {}
+        scheduler.beginRender();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        scheduler.endRender();
+    }
+    // The first frame starts at once, so the loop covers frames - 1 intervals
+    double elapsed = msSince(start);
+    double expected = (frames - 1) * 20.0 + 5.0;
+
+    if (elapsed >= expected - 10.0 && elapsed < (frames - 1) * 24.0 && scheduler.getFramesRendered() == frames &&
+        scheduler.getAverageRenderMs() >= 5.0)
+        std::cout << "Render cost in budget test PASSED!\n";
+    else
+        std::cout << "Render cost in budget test FAILED! (" << elapsed << " ms, expected about " << expected << ")\n";
+}
+
+int main() {
+    if (SDL_Init(SDL_INIT_EVENTS) != 0) {
+        std::cerr << "Error initializing SDL events: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Running FrameScheduler tests...\n";
+    test_pending_input();
+    test_input_wakes_wait();
+    test_idle_skips_frames();
+    test_render_cost_in_budget();
+
+    SDL_Quit();
+    return 0;
+}
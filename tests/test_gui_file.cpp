@@ -1,5 +1,13 @@
 #include "../all_headers.hpp"
 #include "../SoundPlayer.hpp"
+#include "../FrameScheduler.hpp"
+#include "../EventQueue.hpp"
+
+// Prefer the binary scene compiled by `make scenes` and fall back to the XML source
+static std::string layoutFile(const std::string& name) {
+    std::ifstream compiled(name + ".layb");
+    return compiled ? name + ".layb" : name + ".xml";
+}
 
 int main(int argc, char* argv[]) {
     // Initialize SDL
@@ -20,51 +28,78 @@ int main(int argc, char* argv[]) {
     SDL_Surface* screenSurface = SDL_CreateRGBSurface(0, 1280, 720, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
     Screen screen(1280, 720, screenSurface);
 
-    // Initialize SoundPlayer and load a sound file
-    SoundPlayer soundPlayer;
+    // Rasterize dirty regions in parallel tiles on all cores
+    ThreadPool renderPool;
+    TileRenderer tileRenderer(renderPool);
+    // Background parsing, hot reload and sound decoding get a pool of their own: a long
+    // loading task queued on renderPool would sit in front of the tile helpers
+    ThreadPool loaderPool(1);
+
+    // Initialize SoundPlayer and load the default click sound; sounds named by layouts are
+    // decoded on the loader pool as soon as their layout is parsed
+    SoundPlayer soundPlayer(true, &loaderPool);
     if (!soundPlayer.loadSound("ding.wav")) {
         std::cerr << "Failed to load sound file" << std::endl;
     }
 
-    // Load and display the first layout (input1.xml)
-    Parser parser1("input1.xml");
-    auto rootLayout1 = parser1.parseRootLayout();
-    if (!rootLayout1) {
-        std::cerr << "Error: First root layout could not be parsed." << std::endl;
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
-    }
+    // Load and display the first layout (input1.xml). It is parsed on the loader pool, and each
+    // frame attaches the top-level layouts finished so far, so drawing starts before the
+    // whole file is in.
+    auto rootLayout1 = std::make_unique<Layout>(0, 0, 1, 1, true);
     rootLayout1->calculatePosition({0, 0}, {1280, 720});
+    SceneLoader loader1(layoutFile("input1"), loaderPool, LoadMode::Mapped);
 
-    // Create the SHOW ButtonElement in the bottom middle of the screen, hoverable but not clickable
+    // Create the SHOW ButtonElement in the bottom middle of the screen, hoverable but not
+    // clickable; it is added on top once the layout has loaded
     ivec2 showButtonPosition(565, 650);  // Position for bottom middle
     ivec2 buttonSize(150, 50);
     ivec3 buttonColor(0, 255, 0);
-    auto hoverableButton = std::make_unique<ButtonElement>(showButtonPosition, buttonSize, buttonColor, true, false);
-    rootLayout1->addElement(std::move(hoverableButton));
+    ButtonElement hoverableButton(showButtonPosition, buttonSize, buttonColor, true, false);
 
-    // Display the first layout for 5 seconds
+    // Display the first layout for 5 seconds. The scheduler wakes as soon as input arrives,
+    // the queue hands it to the layout once per 60 FPS frame, and a frame is repainted only
+    // when something changed.
+    FrameScheduler scheduler(60.0);
+    EventQueue events;
     Uint32 startTime = SDL_GetTicks();
     while (SDL_GetTicks() - startTime < 5000) {
-        SDL_FillRect(screen.surface, NULL, SDL_MapRGB(screen.surface->format, 0, 0, 0));
-        rootLayout1->render(screen);
-        screen.blitTo(windowSurface);
-        SDL_UpdateWindowSurface(window);
+        if (!loader1.isFinished()) {
+            if (loader1.attachReady(*rootLayout1)) {
+                rootLayout1->prefetchSounds(soundPlayer);
+            }
+            if (loader1.hasFailed()) {
+                std::cerr << "Error: First root layout could not be parsed." << std::endl;
+                SDL_DestroyWindow(window);
+                SDL_Quit();
+                return 1;
+            }
+            if (loader1.isFinished()) {
+                rootLayout1->addElement(hoverableButton);
+            }
+        }
 
+        // Collect input until the next frame is due (keeping to the frame rate while parts
+        // are still loading); only hovering matters for this layout
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (scheduler.waitEvent(event, rootLayout1->hasDirtyRegions() || !events.empty() || !loader1.isFinished())) {
             if (event.type == SDL_QUIT) {
                 SDL_DestroyWindow(window);
                 SDL_Quit();
                 return 0;
             } else if (event.type == SDL_MOUSEMOTION) {
-                // Handle SHOW event for hovering
-                Event showEvent(EventType::SHOW, event.motion.x, event.motion.y);
-                rootLayout1->handleEvent(showEvent, &soundPlayer);
+                events.push(event);
             }
         }
-        SDL_Delay(16); // Delay for 60 FPS
+        events.dispatch(*rootLayout1, &soundPlayer);
+
+        // Repaint and present only the regions that changed since the last frame
+        if (rootLayout1->hasDirtyRegions()) {
+            scheduler.beginRender();
+            auto updated = screen.blitTo(windowSurface, rootLayout1->renderDirty(screen, ivec3(0, 0, 0), &tileRenderer));
+            SDL_UpdateWindowSurfaceRects(window, updated.data(), static_cast<int>(updated.size()));
+            scheduler.endRender();
+            PROFILE_FRAME();
+        }
     }
 
     // Clear the screen after displaying the first layout
@@ -72,47 +107,66 @@ int main(int argc, char* argv[]) {
     screen.blitTo(windowSurface);
     SDL_UpdateWindowSurface(window);
 
-    // Load and interact with the second layout (input.xml)
-    Parser parser2("input.xml");
-    auto rootLayout2 = parser2.parseRootLayout();
+    // Load and interact with the second layout (input.xml). With --watch, edits saved to
+    // input.xml are re-parsed in the background and applied between frames; the scheduler
+    // wakes at least every 100 ms while idle, so a saved edit shows up within that.
+    std::unique_ptr<HotReloader> reloader;
+    std::unique_ptr<Layout> rootLayout2;
+    if (argc > 1 && std::string(argv[1]) == "--watch") {
+        reloader = std::make_unique<HotReloader>("input.xml", loaderPool);
+        rootLayout2 = reloader->load();
+    } else {
+        Parser parser2(layoutFile("input"), LoadMode::Mapped);
+        rootLayout2 = parser2.parseRootLayout(renderPool, TreeMemory::Arena);
+    }
     if (!rootLayout2) {
         std::cerr << "Error: Second root layout could not be parsed." << std::endl;
         SDL_DestroyWindow(window);
         SDL_Quit();
         return 1;
     }
+    rootLayout2->prefetchSounds(soundPlayer);
     rootLayout2->calculatePosition({0, 0}, {1280, 720});
 
     // Create the CLICK ButtonElement in the second layout (clickable with sound but not hoverable)
     ivec2 buttonPosition(50, 25);
-    auto clickableButton = std::make_unique<ButtonElement>(buttonPosition, buttonSize, buttonColor, false, true);
-    rootLayout2->addElement(std::move(clickableButton));
+    ButtonElement clickableButton(buttonPosition, buttonSize, buttonColor, false, true);
+    rootLayout2->addElement(clickableButton);
 
     // Main loop to interact with the second layout
     bool running = true;
     while (running) {
-        SDL_FillRect(screen.surface, NULL, SDL_MapRGB(screen.surface->format, 0, 0, 0));
-        rootLayout2->render(screen);
-        screen.blitTo(windowSurface);
-        SDL_UpdateWindowSurface(window);
-
+        // Clicks and hover positions are queued, then handled together once per frame
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (running && scheduler.waitEvent(event, rootLayout2->hasDirtyRegions() || !events.empty())) {
             if (event.type == SDL_QUIT) {
                 running = false;
-            } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-                // Handle CLICK event
-                Event clickEvent(EventType::CLICK, event.button.x, event.button.y);
-                rootLayout2->handleEvent(clickEvent, &soundPlayer);
-            } else if (event.type == SDL_MOUSEMOTION) {
-                // Handle SHOW event for hovering
-                Event showEvent(EventType::SHOW, event.motion.x, event.motion.y);
-                rootLayout2->handleEvent(showEvent, &soundPlayer);
+            } else {
+                events.push(event);
             }
         }
-        SDL_Delay(16); // Delay for 60 FPS
+        events.dispatch(*rootLayout2, &soundPlayer);
+        if (reloader && reloader->update(*rootLayout2)) {
+            rootLayout2->prefetchSounds(soundPlayer);
+        }
+
+        if (running && rootLayout2->hasDirtyRegions()) {
+            scheduler.beginRender();
+            auto updated = screen.blitTo(windowSurface, rootLayout2->renderDirty(screen, ivec3(0, 0, 0), &tileRenderer));
+            SDL_UpdateWindowSurfaceRects(window, updated.data(), static_cast<int>(updated.size()));
+            scheduler.endRender();
+            PROFILE_FRAME();
+        }
     }
 
+    std::cout << scheduler.getFramesRendered() << " frames rendered, " << scheduler.getAverageRenderMs()
+              << " ms average, " << scheduler.getWorstRenderMs() << " ms worst (budget "
+              << scheduler.getFrameIntervalMs() << " ms); " << events.getReceived() << " input events, "
+              << events.getDispatched() << " dispatched" << std::endl;
+
+    // With make PROFILE=1, print the per-frame timings and write a Chrome trace
+    PROFILE_WRITE("profile.json");
+
     // Clean up and quit SDL
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <cstdio>
+#include <thread>
+#include "all_headers.hpp"
+#include "same_pixels.hpp"
+
+// HotReloader tests: edits saved to a watched layout file reach the live tree through
+// update(), only the edited layouts are rebuilt and repainted, and the result draws the same
+// as parsing the edited file from scratch.
+
+const int RES_X = 200;
+const int RES_Y = 160;
+const std::string kFile = "test_hot_reload.xml";
+
+// Root with a background box and one active nested layout per color, each holding a box
+std::string sceneXml(const ivec3& background, const std::vector<ivec3>& colors) {
+    auto color = [](const ivec3& c) {
+        return "<vec3><x>" + std::to_string(c.x) + "</x><y>" + std::to_string(c.y) + "</y><z>" + std::to_string(c.z) + "</z></vec3>";
+    };
+    std::string xml = "<layout><box><vec2><x>0</x><y>0</y></vec2><vec2><x>199</x><y>159</y></vec2>" + color(background) + "</box>";
+    for (size_t i = 0; i < colors.size(); ++i) {
+        xml += "<layout active=\"true\"><sX>" + std::to_string(0.2f * i) + "</sX><eX>" + std::to_string(0.2f * i + 0.2f) +
+               "</eX><box><vec2><x>2</x><y>10</y></vec2><vec2><x>30</x><y>50</y></vec2>" + color(colors[i]) + "</box></layout>";
+    }
+    return xml + "</layout>";
+}
+
+void writeFile(const std::string& fileName, const std::string& content) {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+// Save the way many editors do: write a temporary file, then rename it over the original
+void writeFileByRename(const std::string& fileName, const std::string& content) {
+    writeFile(fileName + ".tmp", content);
+    std::rename((fileName + ".tmp").c_str(), fileName.c_str());
+}
+
+// Call update() once per "frame" until it applies a reload or gives up after two seconds
+bool waitForReload(HotReloader& reloader, Layout& root) {
+    for (int i = 0; i < 400; ++i) {
+        if (reloader.update(root)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+// What the file draws when parsed from scratch, with the same buttons added by code
+bool matchesFreshParse(const Screen& live, bool withButton) {
+    Parser parser(kFile);
+    auto fresh = parser.parseRootLayout();
+    if (!fresh) return false;
+    fresh->calculatePosition({0, 0}, {RES_X, RES_Y});
+    if (withButton) fresh->addElement(ButtonElement({150, 120}, {40, 30}, {0, 255, 0}, false, true));
+    Screen expected(RES_X, RES_Y);
+    expected.fillRect(expected.bounds(), ivec3(0, 0, 0));
+    fresh->render(expected);
+    return samePixels(live, expected);
+}
+
+// Changing one nested box rebuilds that layout only and repaints only its area
+void test_edit_one_layout(ThreadPool& pool) {
+    writeFile(kFile, sceneXml({40, 40, 40}, {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}}));
+    HotReloader reloader(kFile, pool);
+    auto root = reloader.load();
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    Screen screen(RES_X, RES_Y);
+    root->renderDirty(screen);
+    Layout* first = &root->getNestedLayout(0);
+
+    writeFile(kFile, sceneXml({40, 40, 40}, {{255, 0, 0}, {255, 255, 0}, {0, 0, 255}}));
+    bool reloaded = waitForReload(reloader, *root);
+    std::vector<Rect> repainted = root->renderDirty(screen);
+    // The second layout spans x = 40..79; its box covers x = 42..70, y = 10..50
+    Rect edited(40, 0, 79, RES_Y - 1);
+    bool local = !repainted.empty();
+    for (const Rect& region : repainted) {
+        local = local && edited.contains(region.minX, region.minY) && edited.contains(region.maxX, region.maxY);
+    }
+
+    if (reloaded && reloader.isWatching() && local && first == &root->getNestedLayout(0) &&
+        reloader.getLayoutsReplaced() == 1 && reloader.getLayoutsKept() == 3 && matchesFreshParse(screen, false))
+        std::cout << "Edit one layout test PASSED!\n";
+    else
+        std::cout << "Edit one layout test FAILED! (reloaded " << reloaded << ", " << reloader.getLayoutsReplaced()
+                  << " replaced, " << reloader.getLayoutsKept() << " kept)\n";
+}
+
+// Adding a layout rebuilds the root's children; a button added by code survives a root edit
+void test_structure_and_buttons(ThreadPool& pool) {
+    writeFile(kFile, sceneXml({40, 40, 40}, {{255, 0, 0}, {0, 255, 0}}));
+    HotReloader reloader(kFile, pool);
+    auto root = reloader.load();
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    root->addElement(ButtonElement({150, 120}, {40, 30}, {0, 255, 0}, false, true));
+    Screen screen(RES_X, RES_Y);
+    root->renderDirty(screen);
+
+    writeFileByRename(kFile, sceneXml({60, 60, 90}, {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}}));
+    bool reloaded = waitForReload(reloader, *root);
+    root->renderDirty(screen);
+
+    if (reloaded && root->getNestedCount() == 3 && root->getElements().getButtons().size() == 1 &&
+        reloader.getLayoutsReplaced() == 4 && matchesFreshParse(screen, true))
+        std::cout << "Structure and button test PASSED!\n";
+    else
+        std::cout << "Structure and button test FAILED! (reloaded " << reloaded << ", " << root->getNestedCount()
+                  << " nested, " << reloader.getLayoutsReplaced() << " replaced)\n";
+}
+
+// A file that cannot be parsed leaves the live tree alone; the next good save applies
+void test_failed_reload(ThreadPool& pool) {
+    writeFile(kFile, sceneXml({40, 40, 40}, {{255, 0, 0}}));
+    HotReloader reloader(kFile, pool);
+    auto root = reloader.load();
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    Screen screen(RES_X, RES_Y);
+    root->renderDirty(screen);
+
+    writeFile(kFile, "no layout here");
+    for (int i = 0; i < 400 && reloader.getFailedReloads() == 0; ++i) {
+        reloader.update(*root);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    bool untouched = !root->hasDirtyRegions() && root->getNestedCount() == 1;
+
+    writeFile(kFile, sceneXml({40, 40, 40}, {{0, 255, 255}}));
+    bool reloaded = waitForReload(reloader, *root);
+    root->renderDirty(screen);
+
+    if (reloader.getFailedReloads() == 1 && untouched && reloaded && reloader.getReloads() == 1 &&
+        matchesFreshParse(screen, false))
+        std::cout << "Failed reload test PASSED!\n";
+    else
+        std::cout << "Failed reload test FAILED! (" << reloader.getFailedReloads() << " failed, " << reloader.getReloads()
+                  << " applied)\n";
+}
+
+int main() {
+    ThreadPool pool(1);
+
+    std::cout << "Running HotReloader tests...\n";
+    test_edit_one_layout(pool);
+    test_structure_and_buttons(pool);
+    test_failed_reload(pool);
+    std::remove(kFile.c_str());
+    return 0;
+}
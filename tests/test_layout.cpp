@@ -0,0 +1,158 @@
+#include <iostream>
+#include "all_headers.hpp"
+#include "same_pixels.hpp"
+
+// Layout tests. Each test builds a small layout tree, renders it into an off-screen surface
+// and inspects pixels.
+
+const int RES_X = 200;
+const int RES_Y = 160;
+
+SDL_Surface* createSurface() {
+    return SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+}
+
+Uint32 pixelAt(const Screen& screen, int x, int y) {
+    return static_cast<Uint32*>(screen.surface->pixels)[y * (screen.surface->pitch / 4) + x];
+}
+
+int countColor(const Screen& screen, Uint32 color) {
+    int count = 0;
+    for (int y = 0; y < RES_Y; ++y) {
+        for (int x = 0; x < RES_X; ++x) {
+            count += pixelAt(screen, x, y) == color;
+        }
+    }
+    return count;
+}
+
+// Root with one nested layout holding each primitive type; the red box is 21x11 pixels
+std::unique_ptr<Layout> buildScene() {
+    auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+    auto panel = std::make_unique<Layout>(0.25f, 0.25f, 0.75f, 0.75f, true);
+    panel->addElement(BoxElement({10, 10}, {30, 20}, {255, 0, 0}));
+    panel->addElement(TriangleElement({40, 5}, {80, 15}, {50, 50}, {0, 255, 0}));
+    panel->addElement(LineElement({5, 60}, {90, 75}, {0, 0, 255}));
+    panel->addElement(PointElement({95, 70}, {255, 255, 255}));
+    root->addNestedLayout(std::move(panel));
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    return root;
+}
+
+void test_identity_transform() {
+    auto plain = buildScene();
+    auto identity = buildScene();
+    identity->setTransform(mat3::identity());
+
+    Screen expected(RES_X, RES_Y, createSurface()), result(RES_X, RES_Y, createSurface());
+    plain->render(expected);
+    identity->render(result);
+
+    if (samePixels(expected, result))
+        std::cout << "Identity transform test PASSED!\n";
+    else
+        std::cout << "Identity transform test FAILED!\n";
+}
+
+void test_translate_transform() {
+    auto plain = buildScene();
+    auto moved = buildScene();
+    moved->setTransform(Affine::translate(7, 3));
+
+    Screen expected(RES_X, RES_Y, createSurface()), result(RES_X, RES_Y, createSurface());
+    plain->render(expected);
+    moved->render(result);
+
+    bool pass = true;
+    for (int y = 0; y + 3 < RES_Y; ++y) {
+        for (int x = 0; x + 7 < RES_X; ++x) {
+            pass = pass && pixelAt(expected, x, y) == pixelAt(result, x + 7, y + 3);
+        }
+    }
+
+    if (pass) std::cout << "Translate transform test PASSED!\n";
+    else std::cout << "Translate transform test FAILED!\n";
+}
+
+void test_scale_and_rotate_boxes() {
+    const Uint32 red = 0x00FF0000;
+    auto scaled = buildScene();
+    scaled->setTransform(Affine::scale(2, 2));
+    // A quarter turn about (150, 0) keeps the scene on screen; the box becomes two triangles
+    auto turned = buildScene();
+    turned->setTransform(Affine::translate(150, 0) * mat3({{0, -1, 0}, {1, 0, 0}, {0, 0, 1}}));
+
+    Screen scaledScreen(RES_X, RES_Y, createSurface()), turnedScreen(RES_X, RES_Y, createSurface());
+    scaled->render(scaledScreen);
+    turned->render(turnedScreen);
+
+    int boxArea = 21 * 11;
+    if (countColor(scaledScreen, red) == 4 * boxArea && countColor(turnedScreen, red) == boxArea)
+        std::cout << "Scale and rotate box test PASSED!\n";
+    else
+        std::cout << "Scale and rotate box test FAILED!\n";
+}
+
+void test_transform_marks_dirty() {
+    auto moving = buildScene();
+    Screen screen(RES_X, RES_Y, createSurface());
+    moving->renderDirty(screen);
+
+    moving->setTransform(Affine::translate(7, 3));
+    moving->renderDirty(screen);
+
+    auto reference = buildScene();
+    reference->setTransform(Affine::translate(7, 3));
+    Screen expected(RES_X, RES_Y, createSurface());
+    reference->render(expected);
+
+    if (samePixels(expected, screen) && !moving->hasDirtyRegions())
+        std::cout << "Transform dirty region test PASSED!\n";
+    else
+        std::cout << "Transform dirty region test FAILED!\n";
+}
+
+// The same scene built in an arena draws the same; a tiny first block makes the arena grow
+void test_arena_tree() {
+    auto plain = buildScene();
+    auto arenaRoot = Layout::createArenaRoot(0, 0, 1, 1, true, 64);
+    Layout& panel = arenaRoot->createNestedLayout(0.25f, 0.25f, 0.75f, 0.75f, true);
+    panel.addElement(BoxElement({10, 10}, {30, 20}, {255, 0, 0}));
+    panel.addElement(TriangleElement({40, 5}, {80, 15}, {50, 50}, {0, 255, 0}));
+    panel.addElement(LineElement({5, 60}, {90, 75}, {0, 0, 255}));
+    panel.addElement(PointElement({95, 70}, {255, 255, 255}));
+    arenaRoot->calculatePosition({0, 0}, {RES_X, RES_Y});
+
+    Screen expected(RES_X, RES_Y, createSurface()), result(RES_X, RES_Y, createSurface());
+    plain->render(expected);
+    arenaRoot->render(result);
+
+    // A parsed file built in an arena matches the heap-built tree too
+    Parser heapParser("input1.xml"), arenaParser("input1.xml");
+    auto heapTree = heapParser.parseRootLayout();
+    auto arenaTree = arenaParser.parseRootLayout(TreeMemory::Arena);
+    bool parsedSame = heapTree && arenaTree;
+    if (parsedSame) {
+        heapTree->calculatePosition({0, 0}, {RES_X, RES_Y});
+        arenaTree->calculatePosition({0, 0}, {RES_X, RES_Y});
+        Screen heapScreen(RES_X, RES_Y, createSurface()), arenaScreen(RES_X, RES_Y, createSurface());
+        heapTree->render(heapScreen);
+        arenaTree->render(arenaScreen);
+        parsedSame = samePixels(heapScreen, arenaScreen) && heapTree->getNestedCount() == arenaTree->getNestedCount();
+    }
+
+    if (samePixels(expected, result) && parsedSame)
+        std::cout << "Arena tree test PASSED!\n";
+    else
+        std::cout << "Arena tree test FAILED!\n";
+}
+
+int main() {
+    std::cout << "Running Layout tests...\n";
+    test_identity_transform();
+    test_translate_transform();
+    test_scale_and_rotate_boxes();
+    test_transform_marks_dirty();
+    test_arena_tree();
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <sstream>
+#include "all_headers.hpp"
+#include "same_pixels.hpp"
+
+// SceneLoader and parallel parsing tests: streaming top-level layouts out of the parser, or
+// parsing them on a pool, leaves the scene unchanged, and a root filled part by part on the UI
+// thread draws the same as one parsed in one go, also when tiles render on the loader's pool.
+
+const int RES_X = 1280;
+const int RES_Y = 720;
+const int kCopies = 40;
+const std::string kFile = "test_scene_loader.xml";
+const std::string kBinaryFile = "test_scene_loader.layb";
+
+// input1.xml's body repeated inside one root: root elements, then a nested layout, kCopies times
+bool writeScaledScene() {
+    std::ifstream source("input1.xml");
+    std::stringstream buffer;
+    buffer << source.rdbuf();
+    std::string xml = buffer.str();
+    size_t bodyStart = xml.find("<layout>");
+    size_t bodyEnd = xml.rfind("</layout>");
+    if (bodyStart == std::string::npos || bodyEnd == std::string::npos) return false;
+    bodyStart += std::string("<layout>").size();
+
+    std::ofstream scaled(kFile);
+    scaled << "<layout>";
+    for (int i = 0; i < kCopies; ++i) scaled << xml.substr(bodyStart, bodyEnd - bodyStart);
+    scaled << "</layout>";
+    return true;
+}
+
+// The scene parsed in one go, rendered
+void renderFreshParse(const std::string& fileName, Screen& screen) {
+    Parser parser(fileName);
+    auto root = parser.parseRootLayout();
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    screen.fillRect(screen.bounds(), ivec3(0, 0, 0));
+    root->render(screen);
+}
+
+template <typename T>
+bool sameBytes(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+bool sameScene(const SceneData& a, const SceneData& b) {
+    return sameBytes(a.layouts, b.layouts) && sameBytes(a.primitives, b.primitives) && a.colors == b.colors &&
+           sameBytes(a.sounds, b.sounds) && a.soundNames == b.soundNames;
+}
+
+void test_streamed_scene_matches() {
+    SceneData whole, streamed;
+    Parser wholeParser(kFile);
+    Parser streamedParser(kFile);
+    int layouts = 0;
+    bool parsed = wholeParser.parseScene(whole) &&
+                  streamedParser.parseScene(streamed, [&](const SceneData&, const SceneData&) { ++layouts; });
+
+    if (parsed && layouts == kCopies && sameScene(whole, streamed))
+        std::cout << "Streamed scene test PASSED!\n";
+    else
+        std::cout << "Streamed scene test FAILED! (" << layouts << " layouts streamed)\n";
+}
+
+// Comments, self-closing layouts and root content between and after the layouts must not
+// confuse the pre-scan that splits the root
+const char* kTrickyXml =
+    "<?xml version=\"1.0\"?><!-- <layout> in a comment --><layout active=\"false\"><sX>0.5</sX>"
+    "<box><vec2><x>1</x><y>2</y></vec2><vec2><x>30</x><y>40</y></vec2><vec3><x>9</x><y>9</y><z>9</z></vec3></box>"
+    "<layout active=\"true\"><sound>ding.wav</sound><layout><point><vec2><x>5</x><y>5</y></vec2></point></layout>"
+    "<!-- </layout> --></layout>"
+    "<line><vec2><x>0</x><y>0</y></vec2><vec2><x>9</x><y>9</y></vec2><vec3><x>1</x><y>2</y><z>3</z></vec3></line>"
+    "<layout/><layout><eX>0.5</eX><triangle><vec2><x>0</x><y>0</y></vec2><vec2><x>9</x><y>0</y></vec2>"
+    "<vec2><x>0</x><y>9</y></vec2><vec3><x>1</x><y>2</y><z>3</z></vec3></triangle></layout>"
+    "<point><vec2><x>7</x><y>7</y></vec2></point></layout><layout>ignored</layout>";
+
+void test_parallel_parse(ThreadPool& pool) {
+    const std::string trickyFile = "test_parallel_parse.xml";
+    {
+        std::ofstream tricky(trickyFile);
+        tricky << kTrickyXml;
+    }
+    bool same = true;
+    for (const std::string& fileName : {kFile, trickyFile, std::string("input.xml"), std::string("input1.xml")}) {
+        SceneData serial, parallel;
+        Parser serialParser(fileName);
+        Parser parallelParser(fileName);
+        same = same && serialParser.parseScene(serial) && parallelParser.parseSceneParallel(parallel, pool) &&
+               sameScene(serial, parallel);
+    }
+    std::remove(trickyFile.c_str());
+
+    Parser parser(kFile);
+    auto root = parser.parseRootLayout(pool);
+    if (same && root && root->getNestedCount() == kCopies)
+        std::cout << "Parallel parse test PASSED!\n";
+    else
+        std::cout << "Parallel parse test FAILED!\n";
+}
+
+// Attach whatever is ready once per "frame", repainting the dirty regions each time
+void test_progressive_attach(ThreadPool& pool, const std::string& fileName, size_t expectedParts, const char* name) {
+    auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    Screen screen(RES_X, RES_Y);
+    SceneLoader loader(fileName, pool);
+    int frames = 0;  // Frames that added something
+    while (!loader.isFinished()) {
+        frames += loader.attachReady(*root);
+        root->renderDirty(screen);
+    }
+
+    Screen expected(RES_X, RES_Y);
+    renderFreshParse(fileName, expected);
+    if (!loader.hasFailed() && loader.getPartsAttached() == expectedParts && root->getNestedCount() == kCopies &&
+        samePixels(screen, expected))
+        std::cout << name << " progressive load test PASSED! (" << loader.getPartsAttached() << " parts in "
+                  << frames << " frames)\n";
+    else
+        std::cout << name << " progressive load test FAILED! (" << loader.getPartsAttached() << " parts)\n";
+}
+
+// Tiled frames on the pool the loader parses on. The parse is held back behind a task that
+// waits for the first frame, so that frame can only finish if the renderer does not wait
+// for tile helpers stuck behind the parse; the rest of the file then streams in frame by frame.
+void test_render_while_loading() {
+    ThreadPool pool(1);
+    TileRenderer tiles(pool);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto blocker = pool.submit([released] { released.wait_for(std::chrono::seconds(2)); });
+    SceneLoader loader(kFile, pool);
+
+    // A black box gives the first frame something to tile without changing the picture
+    auto root = std::make_unique<Layout>(0, 0, 1, 1, true);
+    root->addElement(BoxElement({0, 0}, {RES_X - 1, RES_Y - 1}, {0, 0, 0}));
+    root->calculatePosition({0, 0}, {RES_X, RES_Y});
+    Screen screen(RES_X, RES_Y);
+    auto start = std::chrono::steady_clock::now();
+    root->renderDirty(screen, ivec3(0, 0, 0), &tiles);
+    double firstFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    release.set_value();
+
+    while (!loader.isFinished()) {
+        loader.attachReady(*root);
+        root->renderDirty(screen, ivec3(0, 0, 0), &tiles);
+    }
+    blocker.get();
+
+    Screen expected(RES_X, RES_Y);
+    renderFreshParse(kFile, expected);
+    if (firstFrameMs < 1000 && !loader.hasFailed() && root->getNestedCount() == kCopies && samePixels(screen, expected))
+        std::cout << "Render while loading test PASSED!\n";
+    else
+        std::cout << "Render while loading test FAILED! (first frame " << firstFrameMs << " ms)\n";
+}
+
+void test_missing_file(ThreadPool& pool) {
+    Layout root(0, 0, 1, 1, true);
+    SceneLoader loader("no_such_file.xml", pool);
+    bool finished = loader.finish(root);
+
+    if (!finished && loader.isFinished() && loader.hasFailed() && root.getNestedCount() == 0)
+        std::cout << "Missing file test PASSED!\n";
+    else
+        std::cout << "Missing file test FAILED!\n";
+}
+
+int main() {
+    if (!writeScaledScene()) {
+        std::cout << "Could not read input1.xml\n";
+        return 1;
+    }
+    SceneData scene;
+    Parser parser(kFile);
+    parser.parseScene(scene);
+    writeBinaryScene(scene, kBinaryFile);
+    ThreadPool pool(2);
+
+    std::cout << "Running SceneLoader tests...\n";
+    test_streamed_scene_matches();
+    test_parallel_parse(pool);
+    test_progressive_attach(pool, kFile, kCopies, "XML");
+    test_progressive_attach(pool, kBinaryFile, 1, "Binary");
+    test_render_while_loading();
+    test_missing_file(pool);
+    std::remove(kFile.c_str());
+    std::remove(kBinaryFile.c_str());
+    return 0;
+}
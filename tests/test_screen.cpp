@@ -0,0 +1,120 @@
+#include <iostream>
+#include "all_headers.hpp"
+
+// Screen rasterization tests. Each test draws into an off-screen surface and inspects pixels.
+
+const int RES_X = 64;
+const int RES_Y = 64;
+
+SDL_Surface* createSurface() {
+    return SDL_CreateRGBSurface(0, RES_X, RES_Y, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+}
+
+Uint32 pixelAt(const Screen& screen, int x, int y) {
+    return static_cast<Uint32*>(screen.surface->pixels)[y * (screen.surface->pitch / 4) + x];
+}
+
+// Reference coverage test: pixel center strictly inside, or on a top/left edge
+bool referenceCovers(ivec2 p, ivec2 v0, ivec2 v1, ivec2 v2) {
+    auto edge = [](ivec2 a, ivec2 b, ivec2 q) {
+        return (b.x - a.x) * (q.y - a.y) - (b.y - a.y) * (q.x - a.x);
+    };
+    if (edge(v0, v1, v2) < 0) std::swap(v1, v2);
+    ivec2 verts[3] = {v0, v1, v2};
+    for (int i = 0; i < 3; ++i) {
+        ivec2 a = verts[i], b = verts[(i + 1) % 3];
+        int value = edge(a, b, p);
+        bool topLeft = (b.y == a.y && b.x > a.x) || b.y < a.y;
+        if (value < 0 || (value == 0 && !topLeft)) return false;
+    }
+    return true;
+}
+
+void test_triangle_matches_reference() {
+    Screen screen(RES_X, RES_Y, createSurface());
+    ivec2 v0(3, 2), v1(60, 17), v2(21, 58);
+    screen.drawSafeTriangle(v0, v1, v2, ivec3(255, 255, 255));
+
+    bool pass = true;
+    for (int y = 0; y < RES_Y && pass; ++y) {
+        for (int x = 0; x < RES_X; ++x) {
+            bool drawn = pixelAt(screen, x, y) != 0;
+            if (drawn != referenceCovers(ivec2(x, y), v0, v1, v2)) {
+                pass = false;
+                break;
+            }
+        }
+    }
+
+    if (pass) std::cout << "Triangle coverage test PASSED!\n";
+    else std::cout << "Triangle coverage test FAILED!\n";
+}
+
+void test_adjacent_triangles_no_overlap_no_gap() {
+    // Two triangles splitting a square along its diagonal, plus a fan sharing a center vertex
+    Screen first(RES_X, RES_Y, createSurface());
+    Screen second(RES_X, RES_Y, createSurface());
+    ivec2 a(4, 4), b(50, 7), c(47, 55), d(6, 44);
+    first.drawSafeTriangle(a, b, c, ivec3(255, 0, 0));
+    second.drawSafeTriangle(a, c, d, ivec3(0, 255, 0));
+
+    bool pass = true;
+    for (int y = 0; y < RES_Y && pass; ++y) {
+        for (int x = 0; x < RES_X; ++x) {
+            bool inFirst = pixelAt(first, x, y) != 0;
+            bool inSecond = pixelAt(second, x, y) != 0;
+            bool inQuad = referenceCovers(ivec2(x, y), a, b, c) || referenceCovers(ivec2(x, y), a, c, d);
+            if ((inFirst && inSecond) || ((inFirst || inSecond) != inQuad)) {
+                pass = false;
+                break;
+            }
+        }
+    }
+
+    if (pass) std::cout << "Adjacent triangles test PASSED!\n";
+    else std::cout << "Adjacent triangles test FAILED!\n";
+}
+
+void test_triangle_respects_clip() {
+    Screen screen(RES_X, RES_Y, createSurface());
+    screen.setClip(Rect(10, 10, 29, 29));
+    screen.drawSafeTriangle(ivec2(0, 0), ivec2(63, 0), ivec2(0, 63), ivec3(255, 255, 255));
+
+    bool pass = true;
+    for (int y = 0; y < RES_Y; ++y) {
+        for (int x = 0; x < RES_X; ++x) {
+            bool drawn = pixelAt(screen, x, y) != 0;
+            bool expected = x >= 10 && x <= 29 && y >= 10 && y <= 29 &&
+                            referenceCovers(ivec2(x, y), ivec2(0, 0), ivec2(63, 0), ivec2(0, 63));
+            if (drawn != expected) pass = false;
+        }
+    }
+
+    if (pass) std::cout << "Triangle clip test PASSED!\n";
+    else std::cout << "Triangle clip test FAILED!\n";
+}
+
+void test_box_fill() {
+    Screen screen(RES_X, RES_Y, createSurface());
+    screen.drawBox(ivec2(40, 30), ivec2(5, 3), ivec3(0, 0, 255));
+
+    bool pass = true;
+    for (int y = 0; y < RES_Y; ++y) {
+        for (int x = 0; x < RES_X; ++x) {
+            bool expected = x >= 5 && x <= 40 && y >= 3 && y <= 30;
+            if ((pixelAt(screen, x, y) != 0) != expected) pass = false;
+        }
+    }
+
+    if (pass) std::cout << "Box fill test PASSED!\n";
+    else std::cout << "Box fill test FAILED!\n";
+}
+
+int main() {
+    std::cout << "Running Screen tests...\n";
+    test_triangle_matches_reference();
+    test_adjacent_triangles_no_overlap_no_gap();
+    test_triangle_respects_clip();
+    test_box_fill();
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include "all_headers.hpp"
+#include "SoundPlayer.hpp"
+
+// SoundPlayer mixer and AssetCache tests. Most use a player without a device and pull output
+// with mix(); the dummy device test opens a real device on SDL's dummy audio driver and waits
+// for the callback.
+
+// Clip of constant samples on both channels
+std::vector<Sint16> constantClip(int frames, Sint16 value) {
+    return std::vector<Sint16>(static_cast<size_t>(frames) * SoundPlayer::kChannels, value);
+}
+
+// First sample of a freshly mixed block of the given length
+Sint16 mixFrames(SoundPlayer& player, int frames) {
+    std::vector<Sint16> out(static_cast<size_t>(frames) * SoundPlayer::kChannels);
+    player.mix(out.data(), frames);
+    return out[0];
+}
+
+// A second sound starts on top of the first instead of cutting it off
+void test_overlapping_voices() {
+    SoundPlayer player(false);
+    int longClip = player.addClip(constantClip(1000, 1000));
+    int shortClip = player.addClip(constantClip(300, 2000));
+
+    player.play(longClip);
+    Sint16 alone = mixFrames(player, 100);
+    player.play(shortClip);
+    Sint16 both = mixFrames(player, 100);
+    int voicesBoth = player.getActiveVoices();
+    mixFrames(player, 300);  // The short clip ends
+    Sint16 afterShort = mixFrames(player, 100);
+    player.play(longClip);   // Same clip again: both copies play
+    Sint16 twice = mixFrames(player, 100);
+
+    if (alone == 1000 && both == 3000 && voicesBoth == 2 && afterShort == 1000 && twice == 2000)
+        std::cout << "Overlapping voices test PASSED!\n";
+    else
+        std::cout << "Overlapping voices test FAILED! (" << alone << ", " << both << ", " << afterShort << ", " << twice << ")\n";
+}
+
+void test_volume_and_clamping() {
+    SoundPlayer player(false);
+    int clip = player.addClip(constantClip(500, 20000));
+    player.play(clip, SDL_MIX_MAXVOLUME / 2);
+    Sint16 half = mixFrames(player, 100);
+
+    SoundPlayer loud(false);
+    int loudClip = loud.addClip(constantClip(500, 30000));
+    for (int i = 0; i < SoundPlayer::kMaxVoices + 4; ++i) loud.play(loudClip);
+    Sint16 clamped = mixFrames(loud, 100);
+
+    if (half == 10000 && clamped == 32767 && loud.getActiveVoices() == SoundPlayer::kMaxVoices)
+        std::cout << "Volume and clamping test PASSED!\n";
+    else
+        std::cout << "Volume and clamping test FAILED! (" << half << ", " << clamped << ")\n";
+}
+
+// Commands beyond the ring's capacity are dropped and counted, never blocking the caller
+void test_command_ring_full() {
+    SoundPlayer player(false);
+    int clip = player.addClip(constantClip(10, 1));
+    int accepted = 0;
+    for (uint32_t i = 0; i < SoundPlayer::kCommandCapacity + 5; ++i) accepted += player.play(clip);
+    mixFrames(player, 1);
+    bool afterMix = player.play(clip);
+
+    if (accepted == static_cast<int>(SoundPlayer::kCommandCapacity) && player.getDroppedCommands() == 5 && afterMix &&
+        !player.play(clip + 1))
+        std::cout << "Command ring test PASSED!\n";
+    else
+        std::cout << "Command ring test FAILED! (" << accepted << " accepted)\n";
+}
+
+void test_load_wav() {
+    SoundPlayer player(false);
+    int clip = player.loadClip("ding.wav");
+    bool missing = player.loadClip("no_such_file.wav") < 0;
+
+    if (clip == 0 && player.getClip(clip).frames() > 0 && missing && player.clipCount() == 1)
+        std::cout << "WAV decode test PASSED! (" << player.getClip(clip).frames() << " frames at "
+                  << SoundPlayer::kFrequency << " Hz)\n";
+    else
+        std::cout << "WAV decode test FAILED!\n";
+}
+
+// The audio callback plays a 50 ms clip to the end on the dummy driver. The device mixes
+// silence from the moment it opens, so frames are counted from just before play().
+void test_dummy_device() {
+    SoundPlayer player;
+    int clip = player.addClip(constantClip(SoundPlayer::kFrequency / 20, 1000));
+    uint64_t framesBefore = player.getFramesMixed();
+    bool played = player.hasDevice() && player.play(clip);
+    uint64_t framesNeeded = player.getClip(clip).frames() + SoundPlayer::kBufferFrames;
+    auto finished = [&] {
+        return player.getFramesMixed() - framesBefore >= framesNeeded && player.getActiveVoices() == 0;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    while (played && !finished() && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    if (played && finished())
+        std::cout << "Dummy device test PASSED!\n";
+    else
+        std::cout << "Dummy device test FAILED! (" << player.getFramesMixed() - framesBefore
+                  << " frames mixed since play)\n";
+}
+
+void test_asset_cache_decodes_once() {
+    AssetCache cache;
+    const SoundClip* first = cache.get("ding.wav");
+    const SoundClip* second = cache.get("ding.wav");
+    bool missing = cache.get("no_such_file.wav") == nullptr && cache.get("no_such_file.wav") == nullptr;
+
+    if (first && first == second && missing && cache.getDecodes() == 2 && cache.size() == 2)
+        std::cout << "Asset cache decode-once test PASSED!\n";
+    else
+        std::cout << "Asset cache decode-once test FAILED! (" << cache.getDecodes() << " decodes)\n";
+}
+
+// A sound prefetched on the pool plays by name without decoding on the calling thread
+void test_prefetch_then_play() {
+    ThreadPool loader(1);
+    SoundPlayer player(false, &loader);
+    player.prefetch("ding.wav");
+    for (int i = 0; i < 400 && !player.getAssets().isReady("ding.wav"); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    player.playSound("ding.wav");
+    mixFrames(player, 16);
+
+    if (player.getAssets().getStalls() == 0 && player.getAssets().getDecodes() == 1 && player.getActiveVoices() == 1)
+        std::cout << "Prefetch test PASSED!\n";
+    else
+        std::cout << "Prefetch test FAILED! (" << player.getAssets().getStalls() << " stalls)\n";
+}
+
+// <sound> tags survive XML and binary scenes, and clicks play the nearest layout's sound
+void test_layout_sounds() {
+    const std::string xmlFile = "test_sounds.xml", binaryFile = "test_sounds.layb";
+    {
+        std::ofstream xml(xmlFile);
+        xml << "<layout><sound>ding.wav</sound><layout active=\"true\"><sX>0.5</sX></layout></layout>";
+    }
+    SceneData scene;
+    Parser xmlParser(xmlFile);
+    bool parsed = xmlParser.parseScene(scene) && scene.sounds.size() == 1 && scene.sounds[0].layout == 0 &&
+                  scene.soundName(scene.sounds[0]) == "ding.wav";
+    bool written = writeBinaryScene(scene, binaryFile);
+    Parser binaryParser(binaryFile);
+    auto root = binaryParser.parseRootLayout();
+    bool loaded = written && root && root->getSound() == "ding.wav";
+    std::remove(xmlFile.c_str());
+    std::remove(binaryFile.c_str());
+
+    // The nested layout has no sound of its own, so its button plays the root's
+    SoundPlayer player(false);
+    Layout layoutRoot(0, 0, 1, 1, true);
+    layoutRoot.setSound("ding.wav");
+    auto nested = std::make_unique<Layout>(0, 0, 1, 1, true);
+    nested->addElement(ButtonElement({10, 10}, {20, 20}, {255, 255, 255}, false, true));
+    layoutRoot.addNestedLayout(std::move(nested));
+    layoutRoot.calculatePosition({0, 0}, {100, 100});
+    layoutRoot.prefetchSounds(player);
+    layoutRoot.handleEvent(Event(EventType::CLICK, 15, 15), &player);
+    mixFrames(player, 16);
+    bool played = player.getActiveVoices() == 1 && player.getAssets().getStalls() == 0;
+
+    if (parsed && loaded && played)
+        std::cout << "Layout sound test PASSED!\n";
+    else
+        std::cout << "Layout sound test FAILED! (parsed " << parsed << ", loaded " << loaded << ", played " << played << ")\n";
+}
+
+int main() {
+    setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+    std::cout << "Running SoundPlayer tests...\n";
+    test_overlapping_voices();
+    test_volume_and_clamping();
+    test_command_ring_full();
+    test_load_wav();
+    test_asset_cache_decodes_once();
+    test_prefetch_then_play();
+    test_layout_sounds();
+    test_dummy_device();
+    return 0;
+}
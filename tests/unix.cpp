@@ -286,6 +286,80 @@ void test_matrix_equality() {
         std::cout << "Matrix equality test FAILED!\n";
 }
 
+// Fixed-size matrix tests
+constexpr Matrix<int, 2, 3> kFixedLhs({{1, 2, 3}, {4, 5, 6}});
+constexpr Matrix<int, 3, 2> kFixedRhs({{7, 8}, {9, 10}, {11, 12}});
+static_assert(kFixedLhs * kFixedRhs == Matrix<int, 2, 2>({{58, 64}, {139, 154}}), "constexpr multiply");
+static_assert(kFixedLhs.transpose() == Matrix<int, 3, 2>({{1, 4}, {2, 5}, {3, 6}}), "constexpr transpose");
+
+void test_fixed_matrix_creation() {
+    Matrix<int, 3, 4> mat;
+    bool pass = mat.numRows() == 3 && mat.numCols() == 4 && sizeof(mat) == 12 * sizeof(int);
+    for (int i = 0; i < mat.numRows(); ++i) {
+        for (int j = 0; j < mat.numCols(); ++j) {
+            pass = pass && mat(i, j) == 0;
+        }
+    }
+
+    if (pass) std::cout << "Fixed matrix creation test PASSED!\n";
+    else std::cout << "Fixed matrix creation test FAILED!\n";
+}
+
+void test_fixed_matrix_multiplication() {
+    Matrix<int, 2, 2> result = kFixedLhs * kFixedRhs;
+    Matrix<int, 2, 2> expected({{58, 64}, {139, 154}});
+
+    if (result == expected)
+        std::cout << "Fixed matrix multiplication test PASSED!\n";
+    else
+        std::cout << "Fixed matrix multiplication test FAILED!\n";
+}
+
+// The float 3x3 and 4x4 products go through the SIMD kernels; compare with the dynamic matrix
+template <int N>
+bool fixedMatchesDynamic() {
+    Matrix<float, N, N> a, b;
+    Matrix<float> da(N, N), db(N, N);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            a(i, j) = da(i, j) = static_cast<float>(i * N + j + 1);
+            b(i, j) = db(i, j) = static_cast<float>((i + 2) * (j + 1)) - 3.5f;
+        }
+    }
+
+    Matrix<float, N, N> result = a * b;
+    Matrix<float> expected = da * db;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            if (result(i, j) != expected(i, j)) return false;
+        }
+    }
+    return (a * Matrix<float, N, N>::identity()) == a;
+}
+
+void test_fixed_matrix_simd() {
+    if (fixedMatchesDynamic<3>() && fixedMatchesDynamic<4>())
+        std::cout << "Fixed matrix SIMD multiplication test PASSED!\n";
+    else
+        std::cout << "Fixed matrix SIMD multiplication test FAILED!\n";
+}
+
+void test_fixed_matrix_transpose() {
+    Matrix<float, 4, 4> mat;
+    for (int i = 0; i < 16; ++i) mat(i / 4, i % 4) = static_cast<float>(i);
+    Matrix<float, 4, 4> result = mat.transpose();
+
+    bool pass = result.transpose() == mat;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            pass = pass && result(i, j) == mat(j, i);
+        }
+    }
+
+    if (pass) std::cout << "Fixed matrix transpose test PASSED!\n";
+    else std::cout << "Fixed matrix transpose test FAILED!\n";
+}
+
 int main() {
     std::cout << "Running Tvec2 tests...\n";
     test_tvec2_addition();
@@ -315,5 +389,11 @@ int main() {
     test_matrix_transpose();
     test_matrix_equality();
 
+    std::cout << "Running fixed-size Matrix tests...\n";
+    test_fixed_matrix_creation();
+    test_fixed_matrix_multiplication();
+    test_fixed_matrix_simd();
+    test_fixed_matrix_transpose();
+
     return 0;
 }
@@ -0,0 +1,28 @@
+#include "../all_headers.hpp"
+
+// Layout compiler: converts an XML layout into the binary scene format so it can be
+// loaded without tokenizing text. Parser accepts either format transparently.
+//
+// Usage: layoutc <input.xml> <output.layb>
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.xml> <output.layb>" << std::endl;
+        return 1;
+    }
+
+    Parser parser(argv[1], LoadMode::Mapped);
+    SceneData scene;
+    if (!parser.parseScene(scene)) {
+        std::cerr << "Error: " << argv[1] << " could not be parsed." << std::endl;
+        return 1;
+    }
+
+    if (!writeBinaryScene(scene, argv[2])) {
+        std::cerr << "Error: could not write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << argv[1] << " -> " << argv[2] << ": " << scene.layouts.size() << " layouts, "
+              << scene.primitives.size() << " primitives, " << scene.colors.size() << " colors" << std::endl;
+    return 0;
+}
@@ -3,55 +3,39 @@
 
 #include <cmath> // for sqrt function
 #include <stdexcept> // for exception handling
+#include <type_traits> // for the layout checks below
 
 template <typename T>
 class Tvec2
 {
-private:
-    T components[2];  // Array to store vector components (x, y)
-
 public:
-    // Default constructor initializing vector to (0, 0)
-    Tvec2() : components{0, 0}, x(components[0]), y(components[1]) {}
+    // Components stored directly, so the vector is a trivially copyable value type
+    // (2 * sizeof(T) bytes) that can be passed in registers and copied with memcpy
+    T x, y;
 
-    // Copy constructor
-    Tvec2(const Tvec2& cp) : Tvec2() {
-        x = cp.x;
-        y = cp.y;
-    }
+    // Default constructor initializing vector to (0, 0)
+    constexpr Tvec2() : x(0), y(0) {}
 
     // Constructor with given x, y values
-    Tvec2(T _x, T _y) : Tvec2() {
-        x = _x;
-        y = _y;
-    }
-
-    // Assignment operator
-    Tvec2& operator=(const Tvec2& cp) {
-        if (this != &cp) {
-            x = cp.x;
-            y = cp.y;
-        }
-        return *this;
-    }
+    constexpr Tvec2(T _x, T _y) : x(_x), y(_y) {}
 
     // Vector addition
-    Tvec2 operator+(const Tvec2& rhs) const {
+    constexpr Tvec2 operator+(const Tvec2& rhs) const {
         return Tvec2(x + rhs.x, y + rhs.y);
     }
 
     // Vector subtraction
-    Tvec2 operator-(const Tvec2& rhs) const {
+    constexpr Tvec2 operator-(const Tvec2& rhs) const {
         return Tvec2(x - rhs.x, y - rhs.y);
     }
 
     // Scalar multiplication
-    Tvec2 operator*(T scalar) const {
+    constexpr Tvec2 operator*(T scalar) const {
         return Tvec2(x * scalar, y * scalar);
     }
 
     // Dot product of two vectors
-    T dot(const Tvec2& rhs) const {
+    constexpr T dot(const Tvec2& rhs) const {
         return x * rhs.x + y * rhs.y;
     }
 
@@ -80,32 +64,31 @@ public:
     }
 
     // In-place vector addition
-    Tvec2& operator+=(const Tvec2& rhs) {
+    constexpr Tvec2& operator+=(const Tvec2& rhs) {
         x += rhs.x;
         y += rhs.y;
         return *this;
     }
 
     // In-place vector subtraction
-    Tvec2& operator-=(const Tvec2& rhs) {
+    constexpr Tvec2& operator-=(const Tvec2& rhs) {
         x -= rhs.x;
         y -= rhs.y;
         return *this;
     }
 
     // In-place scalar multiplication
-    Tvec2& operator*=(T scalar) {
+    constexpr Tvec2& operator*=(T scalar) {
         x *= scalar;
         y *= scalar;
         return *this;
     }
-
-    // x and y are references to the first and second elements of the array
-    T& x, &y;
 };
 
 // Typedef for common use cases (float and int vectors)
 typedef Tvec2<float> vec2;
 typedef Tvec2<int> ivec2;
 
+static_assert(std::is_trivially_copyable<ivec2>::value && sizeof(ivec2) == 2 * sizeof(int), "ivec2 must stay a plain value type");
+
 #endif // __TVEC2_HPP__
@@ -3,58 +3,39 @@
 
 #include <cmath> // for sqrt function
 #include <stdexcept> // for exception handling
+#include <type_traits> // for the layout checks below
 
 template <typename T>
 class Tvec3
 {
-private:
-    T components[3];  // Array to store vector components (x, y, z)
-
 public:
-    // Default constructor initializing vector to (0, 0, 0)
-    Tvec3() : components{0, 0, 0}, x(components[0]), y(components[1]), z(components[2]) {}
+    // Components stored directly, so the vector is a trivially copyable value type
+    // (3 * sizeof(T) bytes) that can be passed in registers and copied with memcpy
+    T x, y, z;
 
-    // Copy constructor
-    Tvec3(const Tvec3& cp) : Tvec3() {
-        x = cp.x;
-        y = cp.y;
-        z = cp.z;
-    }
+    // Default constructor initializing vector to (0, 0, 0)
+    constexpr Tvec3() : x(0), y(0), z(0) {}
 
     // Constructor with given x, y, z values
-    Tvec3(T _x, T _y, T _z) : Tvec3() {
-        x = _x;
-        y = _y;
-        z = _z;
-    }
-
-    // Assignment operator
-    Tvec3& operator=(const Tvec3& cp) {
-        if (this != &cp) {
-            x = cp.x;
-            y = cp.y;
-            z = cp.z;
-        }
-        return *this;
-    }
+    constexpr Tvec3(T _x, T _y, T _z) : x(_x), y(_y), z(_z) {}
 
     // Vector addition
-    Tvec3 operator+(const Tvec3& rhs) const {
+    constexpr Tvec3 operator+(const Tvec3& rhs) const {
         return Tvec3(x + rhs.x, y + rhs.y, z + rhs.z);
     }
 
     // Vector subtraction
-    Tvec3 operator-(const Tvec3& rhs) const {
+    constexpr Tvec3 operator-(const Tvec3& rhs) const {
         return Tvec3(x - rhs.x, y - rhs.y, z - rhs.z);
     }
 
     // Scalar multiplication
-    Tvec3 operator*(T scalar) const {
+    constexpr Tvec3 operator*(T scalar) const {
         return Tvec3(x * scalar, y * scalar, z * scalar);
     }
 
     // Dot product of two vectors
-    T dot(const Tvec3& rhs) const {
+    constexpr T dot(const Tvec3& rhs) const {
         return x * rhs.x + y * rhs.y + z * rhs.z;
     }
 
@@ -83,7 +64,7 @@ public:
     }
 
     // Cross product of two vectors
-    Tvec3 cross(const Tvec3& rhs) const {
+    constexpr Tvec3 cross(const Tvec3& rhs) const {
         return Tvec3(
             y * rhs.z - z * rhs.y,
             z * rhs.x - x * rhs.z,
@@ -92,7 +73,7 @@ public:
     }
 
     // In-place vector addition
-    Tvec3& operator+=(const Tvec3& rhs) {
+    constexpr Tvec3& operator+=(const Tvec3& rhs) {
         x += rhs.x;
         y += rhs.y;
         z += rhs.z;
@@ -100,7 +81,7 @@ public:
     }
 
     // In-place vector subtraction
-    Tvec3& operator-=(const Tvec3& rhs) {
+    constexpr Tvec3& operator-=(const Tvec3& rhs) {
         x -= rhs.x;
         y -= rhs.y;
         z -= rhs.z;
@@ -108,19 +89,18 @@ public:
     }
 
     // In-place scalar multiplication
-    Tvec3& operator*=(T scalar) {
+    constexpr Tvec3& operator*=(T scalar) {
         x *= scalar;
         y *= scalar;
         z *= scalar;
         return *this;
     }
-
-    // x, y, z are references to the elements of the array
-    T& x, &y, &z;
 };
 
 // Typedef for common use cases (float and int vectors)
 typedef Tvec3<float> vec3;
 typedef Tvec3<int> ivec3;
 
+static_assert(std::is_trivially_copyable<ivec3>::value && sizeof(ivec3) == 3 * sizeof(int), "ivec3 must stay a plain value type");
+
 #endif // __TVEC3_HPP__
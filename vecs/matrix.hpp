@@ -2,12 +2,38 @@
 #define __MATRIX_HPP__
 
 #include <cmath> // for sqrt function
+#include <cstddef> // for size_t
 #include <vector> // for matrix storage
 #include <stdexcept> // for exception handling
+#include <type_traits> // for picking the SIMD kernels
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define MATRIX_SSE 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATRIX_SSE2 1
+#endif
+
+// Lets constexpr code take a faster non-constexpr path at runtime (GCC 9+, Clang 9+)
+#if defined(__GNUC__) || defined(__clang__)
+#define MATRIX_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define MATRIX_CONSTANT_EVALUATED() true
+#endif
+
+// Size parameter marking a matrix whose dimensions are chosen at runtime
+constexpr int kDynamicSize = 0;
+
+// Matrix<T> (the default) is sized at runtime; Matrix<T, R, C> has its size fixed at compile time
+template <typename T, int R = kDynamicSize, int C = kDynamicSize>
+class Matrix;
 
 // Template class for a generic matrix
 template <typename T>
-class Matrix {
+class Matrix<T, kDynamicSize, kDynamicSize> {
 private:
     std::vector<std::vector<T>> data;  // 2D vector to store matrix elements
     int rows, cols;  // Matrix dimensions (rows and columns)
@@ -111,4 +137,178 @@ public:
     }
 };
 
+// SSE kernels for the common float sizes. Matrices are row-major and tightly packed; each
+// result row is built as a sum of rhs rows scaled by the lhs row's elements.
+namespace MatrixKernels {
+#ifdef MATRIX_SSE
+inline void multiply4x4(const float* a, const float* b, float* out) {
+    __m128 row0 = _mm_loadu_ps(b), row1 = _mm_loadu_ps(b + 4), row2 = _mm_loadu_ps(b + 8), row3 = _mm_loadu_ps(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        const float* lhs = a + i * 4;
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(lhs[0]), row0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[1]), row1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[2]), row2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[3]), row3));
+        _mm_storeu_ps(out + i * 4, sum);
+    }
+}
+
+// Rows are 3 floats, so loads and stores must not run past the 9-element arrays: the last
+// rhs row is gathered explicitly and the last result row is stored as 2 + 1 floats.
+// out must not alias a or b.
+inline void multiply3x3(const float* a, const float* b, float* out) {
+    __m128 row0 = _mm_loadu_ps(b), row1 = _mm_loadu_ps(b + 3), row2 = _mm_setr_ps(b[6], b[7], b[8], 0.0f);
+    __m128 result[3];
+    for (int i = 0; i < 3; ++i) {
+        const float* lhs = a + i * 3;
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(lhs[0]), row0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[1]), row1));
+        result[i] = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[2]), row2));
+    }
+    // Each 4-wide store spills one lane into the next row, which the following store overwrites
+    _mm_storeu_ps(out, result[0]);
+    _mm_storeu_ps(out + 3, result[1]);
+    _mm_storel_pi(reinterpret_cast<__m64*>(out + 6), result[2]);
+    _mm_store_ss(out + 8, _mm_movehl_ps(result[2], result[2]));
+}
+#endif
+
+// Apply the affine part of a row-major 3x3 matrix to count integer points in place:
+// (x, y) -> (m0 x + m1 y + m2, m3 x + m4 y + m5), rounded to the nearest integer (ties to even).
+// Points are processed four at a time from separate x and y arrays.
+inline void transformPoints(const float* m, int* xs, int* ys, size_t count) {
+    size_t i = 0;
+#ifdef MATRIX_SSE2
+    const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+    const __m128 m3 = _mm_set1_ps(m[3]), m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)));
+        __m128 y = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)));
+        __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m1, y)), m2);
+        __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m3, x), _mm_mul_ps(m4, y)), m5);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(xs + i), _mm_cvtps_epi32(tx));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ys + i), _mm_cvtps_epi32(ty));
+    }
+#endif
+    for (; i < count; ++i) {
+        float x = static_cast<float>(xs[i]), y = static_cast<float>(ys[i]);
+        xs[i] = static_cast<int>(std::nearbyint(m[0] * x + m[1] * y + m[2]));
+        ys[i] = static_cast<int>(std::nearbyint(m[3] * x + m[4] * y + m[5]));
+    }
+}
+}
+
+// Fixed-size matrix with contiguous row-major storage and no bounds checks.
+// Construction, multiplication and transpose are constexpr; float 3x3 and 4x4 products use
+// the SSE kernels above when evaluated at runtime. Mismatched sizes fail to compile.
+template <typename T, int R, int C>
+class Matrix {
+    static_assert(R > 0 && C > 0, "fixed-size matrices need positive dimensions");
+
+private:
+    T data[R * C];  // Row-major elements
+
+public:
+    // Matrix with all elements set to 0
+    constexpr Matrix() : data{} {}
+
+    // Matrix from a nested array of rows
+    constexpr Matrix(const T (&values)[R][C]) : data{} {
+        for (int i = 0; i < R; ++i) {
+            for (int j = 0; j < C; ++j) {
+                data[i * C + j] = values[i][j];
+            }
+        }
+    }
+
+    static constexpr Matrix identity() {
+        static_assert(R == C, "identity requires a square matrix");
+        Matrix result;
+        for (int i = 0; i < R; ++i) {
+            result.data[i * C + i] = 1;
+        }
+        return result;
+    }
+
+    constexpr T& operator()(int row, int col) { return data[row * C + col]; }
+    constexpr const T& operator()(int row, int col) const { return data[row * C + col]; }
+
+    static constexpr int numRows() { return R; }
+    static constexpr int numCols() { return C; }
+
+    // Pointer to the R * C row-major elements
+    constexpr const T* elements() const { return data; }
+    constexpr T* elements() { return data; }
+
+    // Matrix multiplication
+    template <int K>
+    constexpr Matrix<T, R, K> operator*(const Matrix<T, C, K>& rhs) const {
+        Matrix<T, R, K> result;
+#ifdef MATRIX_SSE
+        if constexpr (std::is_same<T, float>::value && R == C && C == K && (R == 3 || R == 4)) {
+            if (!MATRIX_CONSTANT_EVALUATED()) {
+                if constexpr (R == 3) {
+                    MatrixKernels::multiply3x3(data, rhs.elements(), result.elements());
+                } else {
+                    MatrixKernels::multiply4x4(data, rhs.elements(), result.elements());
+                }
+                return result;
+            }
+        }
+#endif
+        for (int i = 0; i < R; ++i) {
+            for (int j = 0; j < K; ++j) {
+                T sum = 0;
+                for (int k = 0; k < C; ++k) {
+                    sum += data[i * C + k] * rhs(k, j);
+                }
+                result(i, j) = sum;
+            }
+        }
+        return result;
+    }
+
+    // Transpose the matrix (swap rows and columns)
+    constexpr Matrix<T, C, R> transpose() const {
+        Matrix<T, C, R> result;
+        for (int i = 0; i < R; ++i) {
+            for (int j = 0; j < C; ++j) {
+                result(j, i) = data[i * C + j];
+            }
+        }
+        return result;
+    }
+
+    // Equality check between two matrices
+    constexpr bool operator==(const Matrix& rhs) const {
+        for (int i = 0; i < R * C; ++i) {
+            if (data[i] != rhs.data[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+typedef Matrix<float, 3, 3> mat3;
+typedef Matrix<float, 4, 4> mat4;
+
+// 2D affine transforms as 3x3 matrices acting on column vectors (x, y, 1);
+// a * b applies b first
+namespace Affine {
+constexpr mat3 translate(float x, float y) {
+    return mat3({{1, 0, x}, {0, 1, y}, {0, 0, 1}});
+}
+
+constexpr mat3 scale(float x, float y) {
+    return mat3({{x, 0, 0}, {0, y, 0}, {0, 0, 1}});
+}
+
+// Positive angles turn clockwise on screen, since y points down
+inline mat3 rotate(float radians) {
+    float c = std::cos(radians), s = std::sin(radians);
+    return mat3({{c, -s, 0}, {s, c, 0}, {0, 0, 1}});
+}
+}
+
 #endif // __MATRIX_HPP__
\ No newline at end of file